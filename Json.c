@@ -7,9 +7,9 @@
  * GitHub : https://github.com/scottcgi/MojoJson
  *
  * Since  : 2013-5-29
- * Update : 2021-2-6
+ * Update : 2026-10-18
  * Author : scott.cgi
- * Version: 1.2.3
+ * Version: 1.3.0
  */
 
 
@@ -18,11 +18,87 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <stdio.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <time.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "Json.h"
 
-#define ALog_A(e, ...) e ? (void) 0 : printf(__VA_ARGS__), printf("\n"),  assert(e);
-#define ALog_D(...)    printf(__VA_ARGS__)
+#define ALog_A(e, ...) ((e) ? (void) 0 : (printf(__VA_ARGS__), printf("\n"), assert(e)));
+
+#ifdef JSON_TRACE
+    #include <stdarg.h>
+
+    static JsonTrace traceCallback = NULL;
+    static void*     traceContext  = NULL;
+
+    static void Trace(const char* format, ...)
+    {
+        char    message[256];
+        va_list args;
+
+        va_start(args, format);
+        vsnprintf(message, sizeof(message), format, args);
+        va_end(args);
+
+        if (traceCallback != NULL)
+        {
+            traceCallback(traceContext, message);
+        }
+        else
+        {
+            printf("%s\n", message);
+        }
+    }
+
+    #define ALog_D(...) Trace(__VA_ARGS__)
+#else
+    // compiled to nothing, the arguments are not evaluated
+    #define ALog_D(...)
+#endif
+
+
+// Json allocator
+//----------------------------------------------------------------------------------------------------------------------
+
+
+static void* DefaultAlloc(void* context, size_t size)
+{
+    (void) context;
+    return malloc(size);
+}
+
+
+static void* DefaultRealloc(void* context, void* ptr, size_t size)
+{
+    (void) context;
+    return realloc(ptr, size);
+}
+
+
+static void DefaultFree(void* context, void* ptr)
+{
+    (void) context;
+    free(ptr);
+}
+
+
+/**
+ * The malloc, realloc and free of C standard lib.
+ */
+static const JsonAllocator defaultAllocator[1] =
+{{
+    DefaultAlloc,
+    DefaultRealloc,
+    DefaultFree,
+    NULL,
+}};
 
 
 // ArrayList tool for JsonArray
@@ -70,9 +146,9 @@ typedef struct
 ArrayList;
 
 
-static void ArrayListRelease(ArrayList* arrayList)
+static void ArrayListRelease(const JsonAllocator* allocator, ArrayList* arrayList)
 {
-    free(arrayList->elementArr->data);
+    allocator->Free(allocator->context, arrayList->elementArr->data);
     arrayList->elementArr->data   = NULL;
     arrayList->elementArr->length = 0;
     arrayList->size               = 0;
@@ -89,33 +165,44 @@ static void ArrayListInit(int elementTypeSize, ArrayList* arrayList)
 }
 
 
-static void ArrayListAddCapacity(ArrayList* arrayList, int increase)
+/**
+ * If the allocator unable to realloc memory return false, and the list not changed.
+ */
+static bool ArrayListAddCapacity(const JsonAllocator* allocator, ArrayList* arrayList, int increase)
 {
     ALog_A(increase > 0, "Json ArrayListAddCapacity failed, increase = %d cannot <= 0", increase);
 
-    void* data = realloc
+    void* data = allocator->Realloc
                  (
+                     allocator->context,
                      arrayList->elementArr->data,
                      (size_t) (increase + arrayList->elementArr->length) * arrayList->elementTypeSize
                  );
 
-    ALog_A
-    (
-        data != NULL,
-        "Json ArrayListAddCapacity failed, unable to realloc memory, size = %d, length = %d, increase = %d",
-        arrayList->size, arrayList->elementArr->length, increase
-    );
+    if (data == NULL)
+    {
+        return false;
+    }
 
     arrayList->elementArr->data    = data;
     arrayList->elementArr->length += increase;
+
+    return true;
 }
 
 
-static void* ArrayListAdd(ArrayList* arrayList, void* elementPtr)
+/**
+ * If the allocator unable to realloc memory return NULL.
+ */
+static void* ArrayListAdd(const JsonAllocator* allocator, ArrayList* arrayList, void* elementPtr)
 {
-    if (arrayList->size == arrayList->elementArr->length)
+    if
+    (
+        arrayList->size == arrayList->elementArr->length &&
+        ArrayListAddCapacity(allocator, arrayList, arrayList->increase) == false
+    )
     {
-        ArrayListAddCapacity(arrayList, arrayList->increase);
+        return NULL;
     }
 
     return memcpy
@@ -127,11 +214,18 @@ static void* ArrayListAdd(ArrayList* arrayList, void* elementPtr)
 }
 
 
-static void* ArrayListInsert(ArrayList* arrayList, int index, void* elementPtr)
+/**
+ * If the allocator unable to realloc memory return NULL.
+ */
+static void* ArrayListInsert(const JsonAllocator* allocator, ArrayList* arrayList, int index, void* elementPtr)
 {
-    if (arrayList->size == arrayList->elementArr->length)
+    if
+    (
+        arrayList->size == arrayList->elementArr->length &&
+        ArrayListAddCapacity(allocator, arrayList, arrayList->increase) == false
+    )
     {
-        ArrayListAddCapacity(arrayList, arrayList->increase);
+        return NULL;
     }
 
     void* from = (char*) arrayList->elementArr->data + arrayList->elementTypeSize * index;
@@ -154,14 +248,14 @@ static void* ArrayListInsert(ArrayList* arrayList, int index, void* elementPtr)
 /**
  * Shortcut of ArrayListAdd.
  */
-#define AArrayList_Add(arrayList, element) \
-    ArrayListAdd(arrayList, &(element))
+#define AArrayList_Add(allocator, arrayList, element) \
+    ArrayListAdd(allocator, arrayList, &(element))
 
 /**
  * Shortcut of AArrayList->Insert.
  */
-#define AArrayList_Insert(arrayList, index, element) \
-    ArrayListInsert(arrayList, index, &(element))
+#define AArrayList_Insert(allocator, arrayList, index, element) \
+    ArrayListInsert(allocator, arrayList, index, &(element))
 
 
 /**
@@ -217,17 +311,6 @@ typedef struct
 ArrayStrMap;
 
 
-static void ArrayStrMapRelease(ArrayStrMap* arrayStrMap)
-{
-    for (int i = 0; i < arrayStrMap->elementList->size; ++i)
-    {
-        free(AArrayList_Get(arrayStrMap->elementList, i, ArrayStrMapElement*));
-    }
-
-    ArrayListRelease(arrayStrMap->elementList);
-}
-
-
 static void ArrayStrMapInit(int valueTypeSize, ArrayStrMap* outArrayStrMap)
 {
     ArrayListInit(sizeof(ArrayStrMapElement*), outArrayStrMap->elementList);
@@ -268,6 +351,11 @@ static int BinarySearch(ArrayList(ArrayStrMapElement)* elementList, const char*
         {
             high = guess;
         }
+        else if (element->key == key)
+        {
+            // the same key of JsonKeyPool
+            return guess;
+        }
         else if (element->keyLength == keyLength)
         {
             int cmp = memcmp(element->key, key, (size_t) keyLength);
@@ -312,28 +400,25 @@ static void* ArrayStrMapGet(ArrayStrMap* arrayStrMap, const char* key, void* def
 }
 
 
-static void* ArrayStrMapTryPut(ArrayStrMap* arrayStrMap, const char* key, void* valuePtr)
+/**
+ * Insert the element that the key and value already set by caller,
+ * if the key already exists or unable to realloc memory return false and the element not inserted.
+ */
+static bool ArrayStrMapTryInsert
+(
+    const JsonAllocator* allocator,
+    ArrayStrMap*         arrayStrMap,
+    ArrayStrMapElement*  element
+)
 {
-    int keyLength = (int) strlen(key) + 1;
-    int guess     = BinarySearch(arrayStrMap->elementList, key, keyLength);
+    int guess = BinarySearch(arrayStrMap->elementList, element->key, element->keyLength);
 
     if (guess < 0)
     {
-        int                 valueTypeSize = arrayStrMap->valueTypeSize;
-        ArrayStrMapElement* element       = malloc(sizeof(ArrayStrMapElement) + valueTypeSize + keyLength);
-        element->keyLength                = keyLength;
-        element->valuePtr                 = (char*) element + sizeof(ArrayStrMapElement);
-        element->key                      = (char*) element->valuePtr + valueTypeSize;
-
-        memcpy((void*) element->key, key, (size_t) keyLength);
-        AArrayList_Insert(arrayStrMap->elementList, -guess - 1, element);
-
-        return memcpy(element->valuePtr, valuePtr, (size_t) valueTypeSize);
-    }
-    else
-    {
-        return NULL;
+        return AArrayList_Insert(allocator, arrayStrMap->elementList, -guess - 1, element) != NULL;
     }
+
+    return false;
 }
 
 
@@ -353,17 +438,10 @@ static void* ArrayStrMapTryPut(ArrayStrMap* arrayStrMap, const char* key, void*
 
 /**
  * Shortcut of ArrayStrMapGet.
- * return value.
+ * return value pointer, if not found return NULL.
  */
 #define AArrayStrMap_Get(arrayStrMap, key, ValueType) \
-    (*(ValueType*) ArrayStrMapGet(arrayStrMap, key, (void*[1]) {NULL}))
-
-
-/**
- * Shortcut of ArrayStrMapTryPut.
- */
-#define AArrayStrMap_TryPut(arrayStrMap, key, value) \
-    ArrayStrMapTryPut(arrayStrMap, key, &(value))
+    ((ValueType*) ArrayStrMapGet(arrayStrMap, key, NULL))
 
 
 // Define struct of JsonObject and JsonArray
@@ -372,590 +450,8082 @@ static void* ArrayStrMapTryPut(ArrayStrMap* arrayStrMap, const char* key, void*
 
 /**
  * For json object that contains a set of k-v pairs.
+ * the layout mirrored by Json.hpp for inline access, keep them same.
  */
 struct JsonObject
 {
-   ArrayStrMap(objectKey, JsonValue*) valueMap[1];
+   /**
+    * The ArrayStrMapElement pointers follow JsonObject in same memory space,
+    * and each ArrayStrMapElement holds JsonValue.
+    */
+   ArrayStrMap(objectKey, JsonValue) valueMap[1];
+
+   /**
+    * The structural hash that not depends on keys order, 0 means not computed.
+    */
+   uint64_t                          hash;
 };
 
 
 /**
- * For json array that contains a list of json value.
+ * How the elements of JsonArray stored.
  */
-struct JsonArray
+typedef enum
 {
-   ArrayList(JsonValue*) valueList[1];
-};
+    /**
+     * Each element is JsonValue.
+     */
+    JsonPacked_None,
 
+    /**
+     * All elements are integer numbers that stored as int64_t.
+     */
+    JsonPacked_Int64,
 
-// Json value create and destory
-//----------------------------------------------------------------------------------------------------------------------
+    /**
+     * All elements are numbers that stored as double.
+     */
+    JsonPacked_Double,
+}
+JsonPacked;
 
 
 /**
- * If the JsonValue is JsonType_Array,  then free each items and do recursively.
- * if the JsonValue is JsonType_Object, then free each k-v   and do recursively.
+ * The number of packed JsonArray.
  */
-static void Destroy(JsonValue* value)
+typedef union
 {
-    // JsonValue hold the whole memory
-    // so free JsonValue will be release JsonValue's memory
+    int64_t int64;
+    double  float64;
+}
+JsonPackedNumber;
 
-    switch (value->type)
-    {
-        case JsonType_Array:
-        {
-            ArrayList* list = value->jsonArray->valueList;
-            for (int i = 0; i < list->size; ++i)
-            {
-                Destroy(AArrayList_Get(list, i, JsonValue*));
-            }
 
-            ArrayListRelease(list);
-            break;
-        }
+/**
+ * For json array that contains a list of json value.
+ * the layout mirrored by Json.hpp for inline access, keep them same.
+ */
+struct JsonArray
+{
+   /**
+    * The elements follow JsonArray in same memory space,
+    * if packedType is not JsonPacked_None, the element type is int64_t or double.
+    */
+   ArrayList(JsonValue) valueList[1];
+   JsonPacked           packedType;
+
+   /**
+    * The structural hash, 0 means not computed.
+    */
+   uint64_t             hash;
+};
 
-        case JsonType_Object:
-        {
-            ArrayStrMap* map = value->jsonObject->valueMap;
-            for (int i = 0; i < map->elementList->size; ++i)
-            {
-                Destroy(AArrayStrMap_GetAt(map, i, JsonValue*));
-            }
 
-            ArrayStrMapRelease(map);
-            break;
-        }
-            
-        case JsonType_Float:
-            break;
-            
-        case JsonType_String:
-            break;
-            
-        case JsonType_Null:
-            break;
-    }
+_Static_assert(sizeof(JsonValue) == 16,                                  "JsonValue must be 16 bytes");
+_Static_assert(offsetof(JsonValue, type) == JsonValue_ShortStringLength + 1, "JsonValue type must be the last byte");
 
-    free(value);
-}
 
+// the layout read by Json.hpp
+_Static_assert(offsetof(ArrayList, size)                     == JsonLayout_ListSize,         "JsonLayout changed");
+_Static_assert(offsetof(ArrayList, elementArr)               == JsonLayout_ListData,         "JsonLayout changed");
+_Static_assert(sizeof  (ArrayList)                           == JsonLayout_ListBytes,        "JsonLayout changed");
+_Static_assert(offsetof(ArrayStrMapElement, keyLength)       == JsonLayout_ElementKeyLength, "JsonLayout changed");
+_Static_assert(offsetof(ArrayStrMapElement, valuePtr)        == JsonLayout_ElementValue,     "JsonLayout changed");
+_Static_assert(offsetof(JsonObject, valueMap[0].elementList) == JsonLayout_ObjectList,       "JsonLayout changed");
+_Static_assert(offsetof(JsonArray,  packedType)              == JsonLayout_ArrayPackedType,  "JsonLayout changed");
+_Static_assert(JsonPacked_Int64 == 1 && JsonPacked_Double == 2,                              "JsonLayout changed");
 
-static JsonValue* CreateJsonValue(void* data, size_t valueSize, JsonType type)
-{
-    JsonValue* value = malloc(sizeof(JsonValue) + valueSize);
 
-    switch (type)
-    {
-        case JsonType_Float:
-            break;
+/**
+ * The mark in the last byte of jsonShortString that means the string is jsonString.
+ */
+#define JsonValue_LongStringMark 0xFF
 
-        case JsonType_String:
-            value->jsonString = memcpy((char*) value + sizeof(JsonValue), data, valueSize);
-            break;
 
-        case JsonType_Array:
-            value->jsonArray = (JsonArray*) ((char*) value + sizeof(JsonValue));
-            ArrayListInit(sizeof(JsonValue*), value->jsonArray->valueList);
-            break;
+/**
+ * The indexes in reserved of JsonType_Float value,
+ * the lazy number keeps the raw text pointer in jsonString, the length and the cached float in reserved.
+ */
+#define JsonValue_NumberCache    0
+#define JsonValue_NumberLength   4
+#define JsonValue_NumberState    5
 
-        case JsonType_Object:
-            value->jsonObject = (JsonObject*) ((char*) value + sizeof(JsonValue));
-            ArrayStrMapInit(sizeof(JsonValue*), value->jsonObject->valueMap);
-            break;
+/**
+ * The max raw text length of lazy number, the longer number converted when parse.
+ */
+#define JsonValue_MaxLazyNumber  UINT8_MAX
 
-        default:
-            ALog_A(false, "Json CreateJsonValue unknown JsonType = %d", type);
-    }
 
-    value->type = type;
+/**
+ * The state of JsonType_Float value.
+ */
+typedef enum
+{
+    /**
+     * The number converted in jsonFloat.
+     */
+    JsonNumber_Float,
+
+    /**
+     * The number is raw text not converted yet.
+     */
+    JsonNumber_Raw,
 
-    return value;
+    /**
+     * The raw text converted and cached in reserved.
+     */
+    JsonNumber_Cached,
 }
+JsonNumber;
 
-// JsonObject API
-//----------------------------------------------------------------------------------------------------------------------
 
+/**
+ * The string of JsonType_String value.
+ */
+#define AJsonValue_GetString(value)                                                                  \
+    ((uint8_t) (value)->jsonShortString[JsonValue_ShortStringLength] == JsonValue_LongStringMark ? \
+     (value)->jsonString : (value)->jsonShortString)
 
-static bool ObjectGetBool(JsonObject* object, const char* key, bool defaultValue)
-{
-    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue*);
-    return jsonValue != NULL ? strcmp(jsonValue->jsonString, "true") == 0 : defaultValue;
-}
 
+// Json parser memory
+//----------------------------------------------------------------------------------------------------------------------
 
-static int ObjectGetInt(JsonObject* object, const char* key, int defaultValue)
-{
-    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue*);
-    
-    if (jsonValue != NULL)
-    {
-        return (int) jsonValue->jsonFloat;
-    }
-    
-    return defaultValue;
-}
 
+/**
+ * The alignment of each arena allocation.
+ */
+#define JsonArena_Align          8
 
-static float ObjectGetFloat(JsonObject* object, const char* key, float defaultValue)
-{
-    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue*);
-    
-    if (jsonValue != NULL)
-    {
-        return jsonValue->jsonFloat;
-    }
-    
-    return defaultValue;
-}
+/**
+ * The capacity of the first arena block, the next block doubles until JsonArena_MaxBlockSize.
+ */
+#define JsonArena_MinBlockSize   (4  * 1024)
+#define JsonArena_MaxBlockSize   (4  * 1024 * 1024)
 
 
-static char* ObjectGetString(JsonObject* object, const char* key, const char* defaultValue)
+/**
+ * The arena memory block, the allocation memory follows the block header.
+ */
+typedef struct JsonArenaBlock JsonArenaBlock;
+struct JsonArenaBlock
 {
-    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue*);
-    return jsonValue != NULL ? jsonValue->jsonString : (char*) defaultValue;
-}
+    JsonArenaBlock* next;
 
+    /**
+     * The bytes of memory after header.
+     */
+    size_t          capacity;
 
-static JsonObject* ObjectGetObject(JsonObject* object, const char* key)
-{
-    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue*);
-    return jsonValue != NULL ? jsonValue->jsonObject : NULL;
-}
+    /**
+     * The bytes of memory allocated.
+     */
+    size_t          used;
+};
 
 
-static JsonArray* ObjectGetArray(JsonObject* object, const char* key)
+/**
+ * The arena position that parser can roll back to.
+ */
+typedef struct
 {
-    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue*);
-    return jsonValue != NULL ? jsonValue->jsonArray : NULL;
+    JsonArenaBlock* block;
+    size_t          used;
 }
+JsonArenaMark;
 
 
-static JsonType ObjectGetType(JsonObject* object, const char* key)
+/**
+ * The stored value of dedup table.
+ */
+typedef struct
 {
-    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue*);
-
-    if (jsonValue == NULL)
-    {
-        return JsonType_Null;
-    }
+    /**
+     * The structural hash, 0 means empty entry.
+     */
+    uint64_t  hash;
 
-    return jsonValue->type;
+    /**
+     * The long string, JsonArray or JsonObject.
+     */
+    JsonValue value;
 }
+JsonDedupEntry;
 
 
-static const char* ObjectGetKey(JsonObject* object, int index)
-{
-    return ArrayStrMapGetKey(object->valueMap, index);
-}
+/**
+ * The min capacity of dedup table, and the table grows when half full.
+ */
+#define JsonDedup_MinCapacity 64
 
 
-static JsonObject* ObjectGetObjectByIndex(JsonObject* object, int index)
+/**
+ * Parse context that keeps the stacks and arena blocks warm between documents.
+ */
+struct JsonParser
 {
-    return AArrayStrMap_GetAt(object->valueMap, index, JsonValue*)->jsonObject;
-}
+    /**
+     * All memory of parser comes from allocator.
+     */
+    JsonAllocator                  allocator[1];
 
+    /**
+     * If true, all memory of JsonValue comes from arena blocks and released together by Reset,
+     * else each JsonValue allocated by itself and free by Destroy.
+     */
+    bool                           isArena;
 
-static JsonArray* ObjectGetArrayByIndex(JsonObject* object, int index)
-{
-    return AArrayStrMap_GetAt(object->valueMap, index, JsonValue*)->jsonArray;
-}
+    /**
+     * If true, the numbers keep raw text of json string and converted when first get.
+     */
+    bool                           isLazyNumber;
 
+    /**
+     * If true, the structural hash of JsonArray and JsonObject computed when parse.
+     */
+    bool                           isHash;
 
-struct AJsonObject AJsonObject[1] =
-{{
-    ObjectGetBool,
-    ObjectGetInt,
-    ObjectGetFloat,
-    ObjectGetType,
-    ObjectGetString,
-    ObjectGetObject,
-    ObjectGetArray,
-    ObjectGetKey,
-    ObjectGetObjectByIndex,
-    ObjectGetArrayByIndex,
-}};
+    /**
+     * The chain of arena blocks, they are retained by Reset.
+     */
+    JsonArenaBlock*                firstBlock;
 
+    /**
+     * The block that allocate from.
+     */
+    JsonArenaBlock*                currentBlock;
 
-// JsonArray API
-//----------------------------------------------------------------------------------------------------------------------
+    /**
+     * The children of parsing arrays, each array uses the top range of stack.
+     */
+    ArrayList(JsonValue)           valueStack[1];
 
+    /**
+     * The k-v pairs of parsing objects, each object uses the top range of stack.
+     */
+    ArrayList(ArrayStrMapElement*) elementStack[1];
 
-static bool ArrayGetBool(JsonArray* array, int index)
-{
-    return strcmp(AArrayList_Get(array->valueList, index, JsonValue*)->jsonString, "true") == 0;
-}
+    /**
+     * The numbers of parsing array that only has numbers so far.
+     */
+    ArrayList(JsonPackedNumber)    numberStack[1];
 
+    /**
+     * If true, the same long strings and subtrees stored once in dedupTable.
+     */
+    bool                           isDedup;
+
+    /**
+     * If not NULL, the keys of JsonObject stored in pool.
+     */
+    JsonKeyPool*                   keyPool;
+
+    /**
+     * The open addressing table of stored values, the capacity is power of 2.
+     */
+    JsonDedupEntry*                dedupTable;
+    int                            dedupCapacity;
+    int                            dedupCount;
+
+    /**
+     * The dedup result since Reset.
+     */
+    JsonDedupStats                 dedupStats[1];
+
+    /**
+     * The allocator of CreateParser, the allocator field counts and limits the calls into it.
+     */
+    JsonAllocator                  userAllocator[1];
+
+    /**
+     * The limits of each parse, the 0 field of SetLimits changed to max value.
+     */
+    JsonParseLimits                limits[1];
+
+    /**
+     * If true, the time of scanning and building measured into stats.
+     */
+    bool                           isTiming;
+
+    /**
+     * The nesting of parsing JsonArray and JsonObject.
+     */
+    int                            depth;
+
+    /**
+     * The statistics of the last parse.
+     */
+    JsonParseStats                 stats[1];
+};
+
+
+/**
+ * Set the error of stats that the first one wins, and return false for the failed parse.
+ */
+static inline bool ParserFail(JsonParser* parser, JsonParseError error)
+{
+    if (parser->stats->error == JsonParseError_None)
+    {
+        parser->stats->error = error;
+    }
+
+    return false;
+}
+
+
+/**
+ * The limits NULL or 0 field means no limit, but the depth always bounded for the recursion of parse.
+ */
+static void ParserSetLimits(JsonParser* parser, const JsonParseLimits* limits)
+{
+    JsonParseLimits noLimits[1] = {{0}};
+
+    if (limits == NULL)
+    {
+        limits = noLimits;
+    }
+
+    // the max value makes each check one compare
+    parser->limits->maxBytes      = limits->maxBytes      > 0 ? limits->maxBytes      : SIZE_MAX;
+    parser->limits->maxDepth      = limits->maxDepth      > 0 ? limits->maxDepth      : JsonParseLimits_DefaultMaxDepth;
+    parser->limits->maxAllocCount = limits->maxAllocCount > 0 ? limits->maxAllocCount : INT_MAX;
+    parser->limits->maxAllocBytes = limits->maxAllocBytes > 0 ? limits->maxAllocBytes : SIZE_MAX;
+}
+
+
+/**
+ * Count the Alloc or Realloc into stats, if over the limits return false.
+ */
+static bool ParserCountAlloc(JsonParser* parser, size_t size)
+{
+    JsonParseStats* stats = parser->stats;
+
+    if
+    (
+        stats->allocCount == parser->limits->maxAllocCount ||
+        size              >  parser->limits->maxAllocBytes - stats->allocBytes
+    )
+    {
+        return ParserFail(parser, JsonParseError_MaxAlloc);
+    }
+
+    ++stats->allocCount;
+    stats->allocBytes += size;
+
+    return true;
+}
+
+
+static void* ParserLimitAlloc(void* context, size_t size)
+{
+    JsonParser* parser = context;
+
+    if (ParserCountAlloc(parser, size) == false)
+    {
+        return NULL;
+    }
+
+    void* ptr = parser->userAllocator->Alloc(parser->userAllocator->context, size);
+
+    if (ptr == NULL)
+    {
+        ParserFail(parser, JsonParseError_Memory);
+    }
+
+    return ptr;
+}
+
+
+static void* ParserLimitRealloc(void* context, void* ptr, size_t size)
+{
+    JsonParser* parser = context;
+
+    if (ParserCountAlloc(parser, size) == false)
+    {
+        return NULL;
+    }
+
+    void* newPtr = parser->userAllocator->Realloc(parser->userAllocator->context, ptr, size);
+
+    if (newPtr == NULL)
+    {
+        ParserFail(parser, JsonParseError_Memory);
+    }
+
+    return newPtr;
+}
+
+
+static void ParserLimitFree(void* context, void* ptr)
+{
+    JsonParser* parser = context;
+    parser->userAllocator->Free(parser->userAllocator->context, ptr);
+}
+
+
+/**
+ * Make the calls into user allocator counted and limited by parser.
+ */
+static void ParserCountAllocator(JsonParser* parser)
+{
+    parser->allocator->Alloc   = ParserLimitAlloc;
+    parser->allocator->Realloc = ParserLimitRealloc;
+    parser->allocator->Free    = ParserLimitFree;
+    parser->allocator->context = parser;
+}
+
+
+static void ParserInit(const JsonAllocator* allocator, bool isArena, JsonParser* parser)
+{
+    *parser->allocator     = *allocator;
+    *parser->userAllocator = *allocator;
+
+    parser->isArena      = isArena;
+    parser->isLazyNumber = false;
+    parser->isHash       = false;
+    parser->isDedup      = false;
+    parser->keyPool      = NULL;
+    parser->firstBlock   = NULL;
+    parser->currentBlock = NULL;
+
+    parser->dedupTable             = NULL;
+    parser->dedupCapacity          = 0;
+    parser->dedupCount             = 0;
+    parser->dedupStats->dedupCount = 0;
+    parser->dedupStats->savedBytes = 0;
+
+    parser->isTiming = false;
+    parser->depth    = 0;
+    memset(parser->stats, 0, sizeof(JsonParseStats));
+    ParserSetLimits(parser, NULL);
+
+    ArrayListInit(sizeof(JsonValue),           parser->valueStack);
+    ArrayListInit(sizeof(ArrayStrMapElement*), parser->elementStack);
+    ArrayListInit(sizeof(JsonPackedNumber),    parser->numberStack);
+}
+
+
+static void ParserRelease(JsonParser* parser)
+{
+    JsonArenaBlock* block = parser->firstBlock;
+
+    while (block != NULL)
+    {
+        JsonArenaBlock* next = block->next;
+        parser->allocator->Free(parser->allocator->context, block);
+        block = next;
+    }
+
+    parser->firstBlock   = NULL;
+    parser->currentBlock = NULL;
+
+    ArrayListRelease(parser->allocator, parser->valueStack);
+    ArrayListRelease(parser->allocator, parser->elementStack);
+    ArrayListRelease(parser->allocator, parser->numberStack);
+
+    if (parser->dedupTable != NULL)
+    {
+        parser->allocator->Free(parser->allocator->context, parser->dedupTable);
+    }
+
+    parser->dedupTable    = NULL;
+    parser->dedupCapacity = 0;
+    parser->dedupCount    = 0;
+}
+
+
+static JsonArenaBlock* ParserCreateBlock(JsonParser* parser, size_t capacity)
+{
+    JsonArenaBlock* block = parser->allocator->Alloc(parser->allocator->context, sizeof(JsonArenaBlock) + capacity);
+
+    if (block != NULL)
+    {
+        block->next     = NULL;
+        block->capacity = capacity;
+        block->used     = 0;
+    }
+
+    return block;
+}
+
+
+/**
+ * Allocate from the arena blocks when isArena, else from allocator directly.
+ * if the allocator unable to alloc memory return NULL.
+ */
+static void* ParserAlloc(JsonParser* parser, size_t size)
+{
+    if (parser->isArena == false)
+    {
+        return parser->allocator->Alloc(parser->allocator->context, size);
+    }
+
+    size                  = (size + JsonArena_Align - 1) & ~((size_t) JsonArena_Align - 1);
+    JsonArenaBlock* block = parser->currentBlock;
+
+    // move to the retained blocks
+    while (block != NULL && block->used + size > block->capacity)
+    {
+        if (block->next == NULL)
+        {
+            size_t capacity = block->capacity * 2;
+
+            if (capacity > JsonArena_MaxBlockSize)
+            {
+                capacity = JsonArena_MaxBlockSize;
+            }
+
+            if (capacity < size)
+            {
+                capacity = size;
+            }
+
+            block->next = ParserCreateBlock(parser, capacity);
+
+            if (block->next == NULL)
+            {
+                return NULL;
+            }
+        }
+
+        block = block->next;
+    }
+
+    if (block == NULL)
+    {
+        block = ParserCreateBlock(parser, size > JsonArena_MinBlockSize ? size : JsonArena_MinBlockSize);
+
+        if (block == NULL)
+        {
+            return NULL;
+        }
+
+        parser->firstBlock = block;
+    }
+
+    parser->currentBlock = block;
+    void* ptr            = (char*) block + sizeof(JsonArenaBlock) + block->used;
+    block->used         += size;
+
+    return ptr;
+}
+
+
+/**
+ * Get the current position of arena.
+ */
+static inline JsonArenaMark ParserMark(JsonParser* parser)
+{
+    JsonArenaMark mark = {parser->currentBlock, parser->currentBlock != NULL ? parser->currentBlock->used : 0};
+    return mark;
+}
+
+
+/**
+ * Release the arena memory allocated after mark, return the released bytes.
+ *
+ * important: the memory after mark must not be referred.
+ */
+static size_t ParserRollback(JsonParser* parser, JsonArenaMark mark)
+{
+    JsonArenaBlock* block    = parser->firstBlock;
+    size_t          released = 0;
+
+    if (mark.block != NULL)
+    {
+        released         = mark.block->used - mark.used;
+        mark.block->used = mark.used;
+        block            = mark.block->next;
+    }
+
+    // the blocks after mark are only used after mark
+    for (; block != NULL; block = block->next)
+    {
+        released    += block->used;
+        block->used  = 0;
+    }
+
+    parser->currentBlock = mark.block != NULL ? mark.block : parser->firstBlock;
+
+    return released;
+}
+
+
+/**
+ * Free the memory from ParserAlloc, the arena memory only released by Reset.
+ */
+static void ParserFree(JsonParser* parser, void* ptr)
+{
+    if (parser->isArena == false)
+    {
+        parser->allocator->Free(parser->allocator->context, ptr);
+    }
+}
+
+
+// Json value create and destory
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The aligned size of JsonArray head, the elements follow it in same memory space.
+ */
+#define JsonArray_HeadSize ((sizeof(JsonArray) + JsonArena_Align - 1) & ~((size_t) JsonArena_Align - 1))
+
+
+/**
+ * Get the list of JsonArray or JsonObject.
+ * the data pointer of list can be recomputed (elements follow the head in same memory space),
+ * so when the container waiting for free, the data and length of list link the next container and type.
+ */
+static inline ArrayList* GetContainerList(void* container, JsonType type)
+{
+    return type == JsonType_Array ?
+           ((JsonArray*)  container)->valueList :
+           ((JsonObject*) container)->valueMap->elementList;
+}
+
+
+/**
+ * Free the long string of value, or link the JsonArray and JsonObject of value into the pending containers.
+ */
+static void DestroyLinkValue(const JsonAllocator* allocator, JsonValue* value, void** container, JsonType* type)
+{
+    switch (value->type)
+    {
+        case JsonType_Array:
+        case JsonType_Object:
+        {
+            // the jsonArray and jsonObject are same pointer in union
+            void*      child = value->jsonArray;
+            ArrayList* list  = GetContainerList(child, value->type);
+
+            list->elementArr->data   = *container;
+            list->elementArr->length = (int) *type;
+            *container               = child;
+            *type                    = (JsonType) value->type;
+            break;
+        }
+
+        case JsonType_String:
+            if ((uint8_t) value->jsonShortString[JsonValue_ShortStringLength] == JsonValue_LongStringMark)
+            {
+                allocator->Free(allocator->context, value->jsonString);
+            }
+            break;
+
+        case JsonType_Float:
+        case JsonType_Null:
+            break;
+    }
+}
+
+
+/**
+ * Free the memory that JsonValue refers to, but not JsonValue itself.
+ * the JsonArray and JsonObject are linked as pending containers and freed one by one in a loop,
+ * so the deep tree cannot overflow the stack and no extra memory needed.
+ */
+static void DestroyValue(const JsonAllocator* allocator, JsonValue* value)
+{
+    void*    container = NULL;
+    JsonType type      = JsonType_Null;
+
+    DestroyLinkValue(allocator, value, &container, &type);
+
+    while (container != NULL)
+    {
+        ArrayList* list     = GetContainerList(container, type);
+        void*      next     = list->elementArr->data;
+        JsonType   nextType = (JsonType) list->elementArr->length;
+
+        if (type == JsonType_Array)
+        {
+            JsonArray* array    = container;
+            JsonValue* elements = (JsonValue*) ((char*) array + JsonArray_HeadSize);
+
+            for (int i = 0; array->packedType == JsonPacked_None && i < list->size; ++i)
+            {
+                DestroyLinkValue(allocator, elements + i, &next, &nextType);
+            }
+        }
+        else
+        {
+            ArrayStrMapElement** elements = (ArrayStrMapElement**) ((char*) container + sizeof(JsonObject));
+
+            for (int i = 0; i < list->size; ++i)
+            {
+                DestroyLinkValue(allocator, elements[i]->valuePtr, &next, &nextType);
+                allocator->Free(allocator->context, elements[i]);
+            }
+        }
+
+        // the elements in container memory space
+        allocator->Free(allocator->context, container);
+
+        container = next;
+        type      = nextType;
+    }
+}
+
+
+static void Destroy(JsonValue* value)
+{
+    DestroyValue(defaultAllocator, value);
+    defaultAllocator->Free(defaultAllocator->context, value);
+}
+
+
+/**
+ * The root JsonValues waiting for ReclaimDeferred,
+ * each root links the next root by the data pointer of its container list.
+ */
+static _Atomic(JsonValue*) deferredRoots = NULL;
+
+
+static void DestroyDeferred(JsonValue* value)
+{
+    if (value->type != JsonType_Array && value->type != JsonType_Object)
+    {
+        // no children to free
+        Destroy(value);
+        return;
+    }
+
+    ArrayList* list = GetContainerList(value->jsonArray, (JsonType) value->type);
+    JsonValue* head = atomic_load_explicit(&deferredRoots, memory_order_relaxed);
+
+    do
+    {
+        list->elementArr->data = head;
+    }
+    while
+    (
+        atomic_compare_exchange_weak_explicit
+        (
+            &deferredRoots, &head, value, memory_order_release, memory_order_relaxed
+        )
+        == false
+    );
+}
+
+
+static int ReclaimDeferred(void)
+{
+    // take all roots at once, the DestroyDeferred of other threads push into new list
+    JsonValue* value = atomic_exchange_explicit(&deferredRoots, NULL, memory_order_acquire);
+    int        count = 0;
+
+    while (value != NULL)
+    {
+        JsonValue* next = GetContainerList(value->jsonArray, (JsonType) value->type)->elementArr->data;
+
+        Destroy(value);
+        value = next;
+        ++count;
+    }
+
+    return count;
+}
+
+
+/**
+ * Set JsonType_String value, the short string stored inside JsonValue, else copy into parser memory.
+ * if the parser unable to alloc memory return false.
+ */
+static bool SetStringValue(JsonParser* parser, const char* str, int length, JsonValue* outValue)
+{
+    if (length <= JsonValue_ShortStringLength)
+    {
+        memcpy(outValue->jsonShortString, str, (size_t) length);
+        outValue->jsonShortString[length] = '\0';
+
+        // when length is JsonValue_ShortStringLength the last byte is 0 that end the string
+        outValue->jsonShortString[JsonValue_ShortStringLength] = (char) (JsonValue_ShortStringLength - length);
+    }
+    else
+    {
+        char* jsonString = ParserAlloc(parser, (size_t) length + 1);
+
+        if (jsonString == NULL)
+        {
+            return false;
+        }
+
+        memcpy(jsonString, str, (size_t) length);
+        jsonString[length]   = '\0';
+        outValue->jsonString = jsonString;
+        outValue->jsonShortString[JsonValue_ShortStringLength] = (char) JsonValue_LongStringMark;
+    }
+
+    outValue->type = JsonType_String;
+
+    return true;
+}
+
+
+/**
+ * Create JsonArray with capacity of elements in same memory space, the elements count is 0.
+ * if the parser unable to alloc memory return NULL.
+ */
+static JsonArray* CreateJsonArray(JsonParser* parser, int elementTypeSize, int capacity)
+{
+    JsonArray* array = ParserAlloc(parser, JsonArray_HeadSize + (size_t) elementTypeSize * capacity);
+
+    if (array != NULL)
+    {
+        ArrayListInit(elementTypeSize, array->valueList);
+        array->packedType                    = JsonPacked_None;
+        array->hash                          = 0;
+        array->valueList->elementArr->data   = capacity > 0 ? (char*) array + JsonArray_HeadSize : NULL;
+        array->valueList->elementArr->length = capacity;
+    }
+
+    return array;
+}
+
+
+/**
+ * Create JsonObject with capacity of element pointers in same memory space, the elements count is 0.
+ * if the parser unable to alloc memory return NULL.
+ */
+static JsonObject* CreateJsonObject(JsonParser* parser, int capacity)
+{
+    JsonObject* object = ParserAlloc(parser, sizeof(JsonObject) + sizeof(ArrayStrMapElement*) * capacity);
+
+    if (object != NULL)
+    {
+        ArrayList* list = object->valueMap->elementList;
+        ArrayStrMapInit(sizeof(JsonValue), object->valueMap);
+        list->elementArr->data   = capacity > 0 ? (char*) object + sizeof(JsonObject) : NULL;
+        list->elementArr->length = capacity;
+        object->hash             = 0;
+    }
+
+    return object;
+}
+
+
+// Json number
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * Get the float of JsonType_Float value, the lazy number converted on first get and cached in place.
+ * the cache published by atomic state, so the frozen JsonValue of JsonDoc can be read by many threads.
+ */
+static float GetNumberValue(JsonValue* value)
+{
+    if (value->type != JsonType_Float)
+    {
+        return value->jsonFloat;
+    }
+
+    _Atomic(uint8_t)*  state = (_Atomic(uint8_t)*)  (value->reserved + JsonValue_NumberState);
+    _Atomic(uint32_t)* cache = (_Atomic(uint32_t)*) (value->reserved + JsonValue_NumberCache);
+    float              number;
+    uint32_t           bits;
+
+    switch (atomic_load_explicit(state, memory_order_acquire))
+    {
+        case JsonNumber_Raw:
+            // the raw text ends with delimiter of json string
+            number = strtof(value->jsonString, NULL);
+            memcpy(&bits, &number, sizeof(float));
+            atomic_store_explicit(cache, bits,              memory_order_relaxed);
+            atomic_store_explicit(state, JsonNumber_Cached, memory_order_release);
+            return number;
+
+        case JsonNumber_Cached:
+            bits = atomic_load_explicit(cache, memory_order_relaxed);
+            memcpy(&number, &bits, sizeof(float));
+            return number;
+
+        default:
+            return value->jsonFloat;
+    }
+}
+
+
+/**
+ * Get the raw text of lazy number that not end with '\0', if not lazy number return NULL.
+ */
+static const char* GetNumberText(JsonValue* value, int* outLength)
+{
+    if
+    (
+        value->type != JsonType_Float ||
+        atomic_load_explicit
+        (
+            (_Atomic(uint8_t)*) (value->reserved + JsonValue_NumberState), memory_order_relaxed
+        )
+        == JsonNumber_Float
+    )
+    {
+        return NULL;
+    }
+
+    *outLength = value->reserved[JsonValue_NumberLength];
+
+    return value->jsonString;
+}
+
+
+/**
+ * The number normalized from any storage, so the same number has same bits.
+ */
+typedef struct
+{
+    /**
+     * Whether the number is integral in int64 range that stored in int64, otherwise in float64.
+     */
+    bool             isInt64;
+    JsonPackedNumber number;
+}
+JsonExactNumber;
+
+
+/**
+ * Convert double to int64_t that the out of range clamped to INT64_MIN or INT64_MAX, and the NaN is 0,
+ * the cast of out of range double is undefined behavior.
+ */
+static inline int64_t NumberToInt64(double float64)
+{
+    if (float64 >= 9223372036854775808.0)
+    {
+        return INT64_MAX;
+    }
+
+    if (float64 >= -9223372036854775808.0)
+    {
+        return (int64_t) float64;
+    }
+
+    return float64 < 0.0 ? INT64_MIN : 0;
+}
+
+
+/**
+ * Normalize the double of number, the integral double in int64 range stored as int64 (the -0 as 0).
+ */
+static void NumberSetDouble(double float64, JsonExactNumber* outNumber)
+{
+    // the 2^63 is exact in double, and NaN fails the comparisons
+    if (float64 >= -9223372036854775808.0 && float64 < 9223372036854775808.0 && float64 == (double) (int64_t) float64)
+    {
+        outNumber->isInt64      = true;
+        outNumber->number.int64 = (int64_t) float64;
+    }
+    else
+    {
+        outNumber->isInt64        = false;
+        outNumber->number.float64 = float64;
+    }
+}
+
+
+// predefine
+static bool ParsePackedNumber(const char** jsonPtr, JsonPackedNumber* outNumber);
+
+
+/**
+ * Parse the exact number of json number text, the *jsonPtr moves after the number.
+ */
+static void NumberParseExact(const char** jsonPtr, JsonExactNumber* outNumber)
+{
+    if (ParsePackedNumber(jsonPtr, &outNumber->number))
+    {
+        outNumber->isInt64 = true;
+    }
+    else
+    {
+        // the "1.0" and "1" are same number
+        NumberSetDouble(outNumber->number.float64, outNumber);
+    }
+}
+
+
+/**
+ * Get the exact number of JsonType_Float value,
+ * the lazy number parsed from raw text without converting and caching the float.
+ */
+static void GetExactNumber(JsonValue* value, JsonExactNumber* outNumber)
+{
+    int         length;
+    const char* text = GetNumberText(value, &length);
+
+    if (text == NULL)
+    {
+        NumberSetDouble(GetNumberValue(value), outNumber);
+    }
+    else
+    {
+        NumberParseExact(&text, outNumber);
+    }
+}
+
+
+/**
+ * Get the exact number of array element, if the element is not number return false.
+ */
+static bool ArrayGetExactNumber(JsonArray* array, int index, JsonExactNumber* outNumber)
+{
+    switch (array->packedType)
+    {
+        case JsonPacked_Int64:
+            outNumber->isInt64      = true;
+            outNumber->number.int64 = AArrayList_Get(array->valueList, index, int64_t);
+            return true;
+
+        case JsonPacked_Double:
+            NumberSetDouble(AArrayList_Get(array->valueList, index, double), outNumber);
+            return true;
+
+        default:
+        {
+            JsonValue* value = &AArrayList_Get(array->valueList, index, JsonValue);
+
+            if (value->type != JsonType_Float)
+            {
+                return false;
+            }
+
+            GetExactNumber(value, outNumber);
+            return true;
+        }
+    }
+}
+
+
+static bool ExactNumberEquals(const JsonExactNumber* a, const JsonExactNumber* b)
+{
+    return a->isInt64 == b->isInt64 &&
+           (a->isInt64 ? a->number.int64 == b->number.int64 : a->number.float64 == b->number.float64);
+}
+
+
+// Json hash
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The FNV-1a offset basis.
+ */
+#define JsonHash_Seed 14695981039346656037ULL
+
+
+/**
+ * FNV-1a hash of the bytes from hash.
+ */
+static uint64_t HashBytes(uint64_t hash, const char* data, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (uint8_t) data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+
+/**
+ * The finalizer of splitmix64, spread each bit of hash.
+ */
+static inline uint64_t HashMix(uint64_t hash)
+{
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+
+    return hash ^ (hash >> 31);
+}
+
+
+/**
+ * The number hashed by exact bits, so the packed and not packed same numbers have same hash.
+ */
+static uint64_t HashNumber(const JsonExactNumber* number)
+{
+    uint64_t bits;
+    memcpy(&bits, &number->number, sizeof(uint64_t));
+
+    return HashMix(HashMix(bits) ^ (number->isInt64 ? JsonType_Float : JsonType_Float << 8));
+}
+
+
+// predefine
+static uint64_t GetValueHash(JsonValue* value);
+
+
+/**
+ * The ordered combination of elements hash, the result is not 0.
+ */
+static uint64_t HashArray(JsonArray* array)
+{
+    ArrayList* list = array->valueList;
+    uint64_t   hash = HashMix(((uint64_t) JsonType_Array << 32) + (uint64_t) list->size);
+
+    for (int i = 0; i < list->size; ++i)
+    {
+        uint64_t        elementHash;
+        JsonExactNumber number;
+
+        switch (array->packedType)
+        {
+            case JsonPacked_Int64:
+                number.isInt64      = true;
+                number.number.int64 = AArrayList_Get(list, i, int64_t);
+                elementHash         = HashNumber(&number);
+                break;
+
+            case JsonPacked_Double:
+                NumberSetDouble(AArrayList_Get(list, i, double), &number);
+                elementHash = HashNumber(&number);
+                break;
+
+            default:
+                elementHash = GetValueHash(&AArrayList_Get(list, i, JsonValue));
+                break;
+        }
+
+        hash = HashMix(hash * 31 + elementHash);
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+
+/**
+ * The sum of k-v pairs hash that not depends on keys order, the result is not 0.
+ */
+static uint64_t HashObject(JsonObject* object)
+{
+    ArrayList* list = object->valueMap->elementList;
+    uint64_t   hash = HashMix(((uint64_t) JsonType_Object << 32) + (uint64_t) list->size);
+
+    for (int i = 0; i < list->size; ++i)
+    {
+        ArrayStrMapElement* element = AArrayList_Get(list, i, ArrayStrMapElement*);
+        uint64_t            keyHash = HashBytes(JsonHash_Seed, element->key, (size_t) element->keyLength - 1);
+        hash                       += HashMix(keyHash * 31 + GetValueHash(element->valuePtr));
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+
+/**
+ * Get the structural hash of value, the not computed hash of JsonArray and JsonObject computed without storing.
+ */
+static uint64_t GetValueHash(JsonValue* value)
+{
+    switch (value->type)
+    {
+        case JsonType_Array:
+            return value->jsonArray->hash != 0 ? value->jsonArray->hash : HashArray(value->jsonArray);
+
+        case JsonType_Object:
+            return value->jsonObject->hash != 0 ? value->jsonObject->hash : HashObject(value->jsonObject);
+
+        case JsonType_String:
+        {
+            const char* str = AJsonValue_GetString(value);
+            return HashMix(HashBytes(JsonHash_Seed ^ JsonType_String, str, strlen(str)));
+        }
+
+        case JsonType_Float:
+        {
+            JsonExactNumber number;
+            GetExactNumber(value, &number);
+            return HashNumber(&number);
+        }
+
+        default:
+            return HashMix(JsonType_Null);
+    }
+}
+
+
+// Json dedup
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * Whether the values of JsonArray or JsonObject are same,
+ * the children already deduplicated, so the long strings and containers compared by pointer.
+ */
+static bool DedupCellEquals(JsonValue* a, JsonValue* b)
+{
+    if (a->type != b->type)
+    {
+        return false;
+    }
+
+    switch (a->type)
+    {
+        case JsonType_String:
+        {
+            bool isLongA = (uint8_t) a->jsonShortString[JsonValue_ShortStringLength] == JsonValue_LongStringMark;
+            bool isLongB = (uint8_t) b->jsonShortString[JsonValue_ShortStringLength] == JsonValue_LongStringMark;
+
+            if (isLongA || isLongB)
+            {
+                return isLongA && isLongB && a->jsonString == b->jsonString;
+            }
+
+            return strcmp(a->jsonShortString, b->jsonShortString) == 0;
+        }
+
+        case JsonType_Float:
+        {
+            // the lazy number compared by raw text, so the Raw and Cached state of same text are equal
+            int         lengthA;
+            int         lengthB;
+            const char* textA = GetNumberText(a, &lengthA);
+            const char* textB = GetNumberText(b, &lengthB);
+
+            if (textA == NULL || textB == NULL)
+            {
+                return textA == textB && memcmp(&a->jsonFloat, &b->jsonFloat, sizeof(float)) == 0;
+            }
+
+            return lengthA == lengthB && memcmp(textA, textB, (size_t) lengthA) == 0;
+        }
+
+        default:
+            // the jsonArray and jsonObject are same pointer in union
+            return a->jsonArray == b->jsonArray;
+    }
+}
+
+
+/**
+ * Whether the JsonArrays or JsonObjects are same, the children compared by DedupCellEquals.
+ */
+static bool DedupContainerEquals(JsonValue* a, JsonValue* b)
+{
+    if (a->type == JsonType_Array)
+    {
+        JsonArray* arrayA = a->jsonArray;
+        JsonArray* arrayB = b->jsonArray;
+        ArrayList* listA  = arrayA->valueList;
+        ArrayList* listB  = arrayB->valueList;
+
+        if (arrayA->packedType != arrayB->packedType || listA->size != listB->size)
+        {
+            return false;
+        }
+
+        if (arrayA->packedType != JsonPacked_None)
+        {
+            return listA->size == 0 ||
+                   memcmp
+                   (
+                       listA->elementArr->data,
+                       listB->elementArr->data,
+                       (size_t) listA->elementTypeSize * listA->size
+                   )
+                   == 0;
+        }
+
+        for (int i = 0; i < listA->size; ++i)
+        {
+            JsonValue* valueA = &AArrayList_Get(listA, i, JsonValue);
+            JsonValue* valueB = &AArrayList_Get(listB, i, JsonValue);
+
+            if (DedupCellEquals(valueA, valueB) == false)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // the elements sorted by key, so same objects have same order
+    ArrayList* listA = a->jsonObject->valueMap->elementList;
+    ArrayList* listB = b->jsonObject->valueMap->elementList;
+
+    if (listA->size != listB->size)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < listA->size; ++i)
+    {
+        ArrayStrMapElement* elementA = AArrayList_Get(listA, i, ArrayStrMapElement*);
+        ArrayStrMapElement* elementB = AArrayList_Get(listB, i, ArrayStrMapElement*);
+
+        if
+        (
+            elementA->keyLength != elementB->keyLength                                   ||
+            memcmp(elementA->key, elementB->key, (size_t) elementA->keyLength) != 0 ||
+            DedupCellEquals(elementA->valuePtr, elementB->valuePtr) == false
+        )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Double the capacity of dedup table, if unable to alloc memory return false and the table not changed.
+ */
+static bool DedupGrow(JsonParser* parser)
+{
+    int             capacity = parser->dedupCapacity > 0 ? parser->dedupCapacity * 2 : JsonDedup_MinCapacity;
+    JsonDedupEntry* table    = parser->allocator->Alloc
+                               (
+                                   parser->allocator->context, sizeof(JsonDedupEntry) * capacity
+                               );
+
+    if (table == NULL)
+    {
+        return false;
+    }
+
+    memset(table, 0, sizeof(JsonDedupEntry) * capacity);
+
+    for (int i = 0; i < parser->dedupCapacity; ++i)
+    {
+        JsonDedupEntry* entry = parser->dedupTable + i;
+
+        if (entry->hash != 0)
+        {
+            int index = (int) (entry->hash & (uint64_t) (capacity - 1));
+
+            while (table[index].hash != 0)
+            {
+                index = (index + 1) & (capacity - 1);
+            }
+
+            table[index] = *entry;
+        }
+    }
+
+    parser->allocator->Free(parser->allocator->context, parser->dedupTable);
+    parser->dedupTable    = table;
+    parser->dedupCapacity = capacity;
+
+    return true;
+}
+
+
+/**
+ * Store the value with hash, if unable to alloc memory the value not stored (dedup is best effort).
+ */
+static void DedupInsert(JsonParser* parser, uint64_t hash, JsonValue* value)
+{
+    if ((parser->dedupCount + 1) * 2 > parser->dedupCapacity && DedupGrow(parser) == false)
+    {
+        return;
+    }
+
+    int index = (int) (hash & (uint64_t) (parser->dedupCapacity - 1));
+
+    while (parser->dedupTable[index].hash != 0)
+    {
+        index = (index + 1) & (parser->dedupCapacity - 1);
+    }
+
+    parser->dedupTable[index].hash  = hash;
+    parser->dedupTable[index].value = *value;
+    ++parser->dedupCount;
+}
+
+
+/**
+ * Get the stored long string that same as str, if not found return NULL.
+ */
+static JsonValue* DedupFindString(JsonParser* parser, uint64_t hash, const char* str, int length)
+{
+    for
+    (
+        int index = (int) (hash & (uint64_t) (parser->dedupCapacity - 1));
+        parser->dedupCapacity > 0 && parser->dedupTable[index].hash != 0;
+        index = (index + 1) & (parser->dedupCapacity - 1)
+    )
+    {
+        JsonValue* value = &parser->dedupTable[index].value;
+
+        if
+        (
+            parser->dedupTable[index].hash == hash                 &&
+            value->type                    == JsonType_String      &&
+            memcmp(value->jsonString, str, (size_t) length) == 0 &&
+            value->jsonString[length]      == '\0'
+        )
+        {
+            return value;
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Get the stored JsonArray or JsonObject that same as value, if not found return NULL.
+ */
+static JsonValue* DedupFindContainer(JsonParser* parser, uint64_t hash, JsonValue* value)
+{
+    for
+    (
+        int index = (int) (hash & (uint64_t) (parser->dedupCapacity - 1));
+        parser->dedupCapacity > 0 && parser->dedupTable[index].hash != 0;
+        index = (index + 1) & (parser->dedupCapacity - 1)
+    )
+    {
+        JsonValue* stored = &parser->dedupTable[index].value;
+
+        if
+        (
+            parser->dedupTable[index].hash == hash        &&
+            stored->type                   == value->type &&
+            DedupContainerEquals(stored, value)
+        )
+        {
+            return stored;
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Set the long string value that stored once, if the parser unable to alloc memory return false.
+ */
+static bool DedupSetString(JsonParser* parser, const char* str, int length, JsonValue* outValue)
+{
+    uint64_t   hash   = HashMix(HashBytes(JsonHash_Seed ^ JsonType_String, str, (size_t) length)) | 1;
+    JsonValue* stored = DedupFindString(parser, hash, str, length);
+
+    if (stored != NULL)
+    {
+        *outValue = *stored;
+        parser->dedupStats->dedupCount += 1;
+        parser->dedupStats->savedBytes += ((size_t) length + JsonArena_Align) & ~((size_t) JsonArena_Align - 1);
+
+        return true;
+    }
+
+    if (SetStringValue(parser, str, length, outValue) == false)
+    {
+        return false;
+    }
+
+    DedupInsert(parser, hash, outValue);
+
+    return true;
+}
+
+
+/**
+ * Replace the JsonArray or JsonObject of value by the stored one, and release the arena memory after mark.
+ * the container hash and its children hashes are computed.
+ */
+static void DedupContainer(JsonParser* parser, JsonArenaMark mark, JsonValue* value)
+{
+    // the hash of JsonArray and JsonObject is not 0
+    uint64_t   hash   = value->type == JsonType_Array ? value->jsonArray->hash : value->jsonObject->hash;
+    JsonValue* stored = DedupFindContainer(parser, hash, value);
+
+    if (stored != NULL)
+    {
+        *value = *stored;
+        parser->dedupStats->dedupCount += 1;
+        // all children of value are stored ones, so the memory after mark not referred
+        parser->dedupStats->savedBytes += ParserRollback(parser, mark);
+    }
+    else
+    {
+        DedupInsert(parser, hash, value);
+    }
+}
+
+
+// JsonKeyPool shared keys
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The shards of JsonKeyPool, each shard locked by itself.
+ */
+#define JsonKeyPool_ShardCount 16
+
+/**
+ * The min capacity of shard table, and the table grows when half full.
+ */
+#define JsonKeyPool_MinCapacity 64
+
+/**
+ * The max keys of shard, the keys spread over shards by hash.
+ */
+#define JsonKeyPool_MaxShardCount (JsonKeyPool_MaxCount / JsonKeyPool_ShardCount)
+
+
+/**
+ * The part of JsonKeyPool that selected by key hash.
+ */
+typedef struct
+{
+    /**
+     * The spinlock of table.
+     */
+    atomic_flag     lock;
+
+    /**
+     * The open addressing table of keys, the capacity is power of 2.
+     */
+    const JsonKey** table;
+    int             capacity;
+    int             count;
+}
+JsonKeyShard;
+
+
+struct JsonKeyPool
+{
+    JsonKeyShard shards[JsonKeyPool_ShardCount];
+};
+
+
+static JsonKeyPool* KeyPoolCreate(void)
+{
+    JsonKeyPool* pool = malloc(sizeof(JsonKeyPool));
+
+    if (pool != NULL)
+    {
+        for (int i = 0; i < JsonKeyPool_ShardCount; ++i)
+        {
+            JsonKeyShard* shard = pool->shards + i;
+
+            atomic_flag_clear(&shard->lock);
+            shard->table    = NULL;
+            shard->capacity = 0;
+            shard->count    = 0;
+        }
+    }
+
+    return pool;
+}
+
+
+static void KeyPoolDestroy(JsonKeyPool* pool)
+{
+    for (int i = 0; i < JsonKeyPool_ShardCount; ++i)
+    {
+        JsonKeyShard* shard = pool->shards + i;
+
+        for (int j = 0; j < shard->capacity; ++j)
+        {
+            // the key string in JsonKey memory space
+            free((void*) shard->table[j]);
+        }
+
+        free(shard->table);
+    }
+
+    free(pool);
+}
+
+
+static inline void KeyShardLock(JsonKeyShard* shard)
+{
+    while (atomic_flag_test_and_set_explicit(&shard->lock, memory_order_acquire))
+    {
+        // spin, the lock only holds a table probe or rehash, no allocation
+    }
+}
+
+
+static inline void KeyShardUnlock(JsonKeyShard* shard)
+{
+    atomic_flag_clear_explicit(&shard->lock, memory_order_release);
+}
+
+
+/**
+ * Find the JsonKey in locked shard, if not found return NULL.
+ */
+static const JsonKey* KeyShardFind(JsonKeyShard* shard, const char* key, int length, uint64_t hash)
+{
+    if (shard->capacity == 0)
+    {
+        return NULL;
+    }
+
+    for
+    (
+        int index = (int) (hash & (uint64_t) (shard->capacity - 1));
+        shard->table[index] != NULL;
+        index = (index + 1) & (shard->capacity - 1)
+    )
+    {
+        const JsonKey* poolKey = shard->table[index];
+
+        if
+        (
+            poolKey->hash   == hash   &&
+            poolKey->length == length &&
+            memcmp(poolKey->key, key, (size_t) length) == 0
+        )
+        {
+            return poolKey;
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Move the keys of locked shard into the empty table of capacity, and return the old table to free after unlock.
+ */
+static const JsonKey** KeyShardRehash(JsonKeyShard* shard, const JsonKey** table, int capacity)
+{
+    for (int i = 0; i < shard->capacity; ++i)
+    {
+        const JsonKey* key = shard->table[i];
+
+        if (key != NULL)
+        {
+            int index = (int) (key->hash & (uint64_t) (capacity - 1));
+
+            while (table[index] != NULL)
+            {
+                index = (index + 1) & (capacity - 1);
+            }
+
+            table[index] = key;
+        }
+    }
+
+    const JsonKey** oldTable = shard->table;
+    shard->table             = table;
+    shard->capacity          = capacity;
+
+    return oldTable;
+}
+
+
+/**
+ * Alloc the JsonKey with the key string in its memory space, if unable to alloc memory return NULL.
+ */
+static JsonKey* KeyPoolNewKey(const char* key, int length, uint64_t hash)
+{
+    JsonKey* poolKey = malloc(sizeof(JsonKey) + (size_t) length + 1);
+
+    if (poolKey != NULL)
+    {
+        char* str = (char*) poolKey + sizeof(JsonKey);
+        memcpy(str, key, (size_t) length);
+        str[length] = '\0';
+
+        poolKey->key    = str;
+        poolKey->length = length;
+        poolKey->hash   = hash;
+    }
+
+    return poolKey;
+}
+
+
+/**
+ * Get the JsonKey of key in pool, if not found store a new one.
+ * the new key and table are allocated without lock, then the shard probed again,
+ * because other threads may store the same key or grow the table in the meantime.
+ */
+static const JsonKey* KeyPoolIntern(JsonKeyPool* pool, const char* key, int length)
+{
+    if (length > JsonKeyPool_MaxKeyLength)
+    {
+        return NULL;
+    }
+
+    uint64_t        hash     = HashBytes(JsonHash_Seed, key, (size_t) length);
+    // the high bits select shard, and the low bits select index of table
+    JsonKeyShard*   shard    = pool->shards + (hash >> 60) % JsonKeyPool_ShardCount;
+    JsonKey*        newKey   = NULL;
+    const JsonKey** newTable = NULL;
+    int             capacity = 0;
+    const JsonKey** oldTable = NULL;
+    const JsonKey*  result;
+
+    while (true)
+    {
+        KeyShardLock(shard);
+        result = KeyShardFind(shard, key, length, hash);
+
+        if (result != NULL || shard->count == JsonKeyPool_MaxShardCount)
+        {
+            break;
+        }
+
+        // the table grows when half full
+        int  needCapacity = (shard->count + 1) * 2 <= shard->capacity ? shard->capacity     :
+                            shard->capacity > 0                       ? shard->capacity * 2 :
+                                                                        JsonKeyPool_MinCapacity;
+        bool isGrow       = needCapacity != shard->capacity;
+
+        if (newKey != NULL && (isGrow == false || capacity == needCapacity))
+        {
+            if (isGrow)
+            {
+                oldTable = KeyShardRehash(shard, newTable, capacity);
+                newTable = NULL;
+            }
+
+            int index = (int) (hash & (uint64_t) (shard->capacity - 1));
+
+            while (shard->table[index] != NULL)
+            {
+                index = (index + 1) & (shard->capacity - 1);
+            }
+
+            shard->table[index] = newKey;
+            result              = newKey;
+            newKey              = NULL;
+            ++shard->count;
+            break;
+        }
+
+        KeyShardUnlock(shard);
+
+        if (newKey == NULL)
+        {
+            newKey = KeyPoolNewKey(key, length, hash);
+
+            if (newKey == NULL)
+            {
+                return NULL;
+            }
+        }
+
+        if (isGrow && capacity != needCapacity)
+        {
+            // the table of other capacity is stale
+            free(newTable);
+            newTable = calloc((size_t) needCapacity, sizeof(JsonKey*));
+            capacity = needCapacity;
+
+            if (newTable == NULL)
+            {
+                free(newKey);
+                return NULL;
+            }
+        }
+    }
+
+    KeyShardUnlock(shard);
+
+    // the key stored by other thread, or the table replaced
+    free(newKey);
+    free(newTable);
+    free(oldTable);
+
+    return result;
+}
+
+
+static int KeyPoolGetCount(JsonKeyPool* pool)
+{
+    int count = 0;
+
+    for (int i = 0; i < JsonKeyPool_ShardCount; ++i)
+    {
+        JsonKeyShard* shard = pool->shards + i;
+
+        KeyShardLock(shard);
+        count += shard->count;
+        KeyShardUnlock(shard);
+    }
+
+    return count;
+}
+
+
+struct AJsonKeyPool AJsonKeyPool[1] =
+{{
+    KeyPoolCreate,
+    KeyPoolDestroy,
+    KeyPoolIntern,
+    KeyPoolGetCount,
+}};
+
+
+// JsonObject API
+//----------------------------------------------------------------------------------------------------------------------
+
+
+static bool ObjectGetBool(JsonObject* object, const char* key, bool defaultValue)
+{
+    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue);
+    return jsonValue != NULL ? strcmp(AJsonValue_GetString(jsonValue), "true") == 0 : defaultValue;
+}
+
+
+static int ObjectGetInt(JsonObject* object, const char* key, int defaultValue)
+{
+    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue);
+    
+    if (jsonValue != NULL)
+    {
+        return (int) GetNumberValue(jsonValue);
+    }
+    
+    return defaultValue;
+}
+
+
+static float ObjectGetFloat(JsonObject* object, const char* key, float defaultValue)
+{
+    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue);
+    
+    if (jsonValue != NULL)
+    {
+        return GetNumberValue(jsonValue);
+    }
+    
+    return defaultValue;
+}
+
+
+static char* ObjectGetString(JsonObject* object, const char* key, const char* defaultValue)
+{
+    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue);
+    return jsonValue != NULL ? AJsonValue_GetString(jsonValue) : (char*) defaultValue;
+}
+
+
+static JsonObject* ObjectGetObject(JsonObject* object, const char* key)
+{
+    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue);
+    return jsonValue != NULL ? jsonValue->jsonObject : NULL;
+}
+
+
+static JsonArray* ObjectGetArray(JsonObject* object, const char* key)
+{
+    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue);
+    return jsonValue != NULL ? jsonValue->jsonArray : NULL;
+}
+
+
+static JsonType ObjectGetType(JsonObject* object, const char* key)
+{
+    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue);
+
+    if (jsonValue == NULL)
+    {
+        return JsonType_Null;
+    }
+
+    return jsonValue->type;
+}
+
+
+static const char* ObjectGetKey(JsonObject* object, int index)
+{
+    return ArrayStrMapGetKey(object->valueMap, index);
+}
+
+
+static JsonObject* ObjectGetObjectByIndex(JsonObject* object, int index)
+{
+    return AArrayStrMap_GetAt(object->valueMap, index, JsonValue).jsonObject;
+}
+
+
+static JsonArray* ObjectGetArrayByIndex(JsonObject* object, int index)
+{
+    return AArrayStrMap_GetAt(object->valueMap, index, JsonValue).jsonArray;
+}
+
+
+static JsonValue* ObjectGetValue(JsonObject* object, const JsonKey* key)
+{
+    // the key of JsonKeyPool compared by pointer when parser uses the same pool
+    int guess = BinarySearch(object->valueMap->elementList, key->key, key->length + 1);
+
+    return guess >= 0 ? &AArrayStrMap_GetAt(object->valueMap, guess, JsonValue) : NULL;
+}
+
+
+static const char* ObjectGetNumberText(JsonObject* object, const char* key, int* outLength)
+{
+    JsonValue* jsonValue = AArrayStrMap_Get(object->valueMap, key, JsonValue);
+    return jsonValue != NULL ? GetNumberText(jsonValue, outLength) : NULL;
+}
+
+
+struct AJsonObject AJsonObject[1] =
+{{
+    ObjectGetBool,
+    ObjectGetInt,
+    ObjectGetFloat,
+    ObjectGetType,
+    ObjectGetString,
+    ObjectGetObject,
+    ObjectGetArray,
+    ObjectGetKey,
+    ObjectGetObjectByIndex,
+    ObjectGetArrayByIndex,
+    ObjectGetNumberText,
+    ObjectGetValue,
+}};
+
+
+// JsonArray API
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * Get the number of packed JsonArray as double.
+ */
+static inline double ArrayGetPackedDouble(JsonArray* array, int index)
+{
+    return array->packedType == JsonPacked_Int64 ?
+           (double) AArrayList_Get(array->valueList, index, int64_t) :
+           AArrayList_Get(array->valueList, index, double);
+}
+
+
+/**
+ * Get the number of packed JsonArray as int64_t.
+ */
+static inline int64_t ArrayGetPackedInt64(JsonArray* array, int index)
+{
+    return array->packedType == JsonPacked_Int64 ?
+           AArrayList_Get(array->valueList, index, int64_t) :
+           NumberToInt64(AArrayList_Get(array->valueList, index, double));
+}
+
+
+static bool ArrayGetBool(JsonArray* array, int index)
+{
+    if (array->packedType != JsonPacked_None)
+    {
+        return false;
+    }
+
+    return strcmp(AJsonValue_GetString(&AArrayList_Get(array->valueList, index, JsonValue)), "true") == 0;
+}
+
+
+static int ArrayGetInt(JsonArray* array, int index)
+{
+    if (array->packedType != JsonPacked_None)
+    {
+        return (int) ArrayGetPackedInt64(array, index);
+    }
+
+    return (int) GetNumberValue(&AArrayList_Get(array->valueList, index, JsonValue));
+}
+
+static float ArrayGetFloat(JsonArray* array, int index)
+{
+    if (array->packedType != JsonPacked_None)
+    {
+        return (float) ArrayGetPackedDouble(array, index);
+    }
+
+    return GetNumberValue(&AArrayList_Get(array->valueList, index, JsonValue));
+}
+
+
+static char* ArrayGetString(JsonArray* array, int index)
+{
+    if (array->packedType != JsonPacked_None)
+    {
+        return NULL;
+    }
+
+    return AJsonValue_GetString(&AArrayList_Get(array->valueList, index, JsonValue));
+}
+
+
+static JsonObject* ArrayGetObject(JsonArray* array, int index)
+{
+    if (array->packedType != JsonPacked_None)
+    {
+        return NULL;
+    }
+
+    return AArrayList_Get(array->valueList, index, JsonValue).jsonObject;
+}
+
+
+static JsonArray* ArrayGetArray(JsonArray* array, int index)
+{
+    if (array->packedType != JsonPacked_None)
+    {
+        return NULL;
+    }
+
+    return AArrayList_Get(array->valueList, index, JsonValue).jsonArray;
+}
+
+
+static JsonType ArrayGetType(JsonArray* array, int index)
+{
+    if (index < 0 || index >= array->valueList->size)
+    {
+        return JsonType_Null;
+    }
+
+    if (array->packedType != JsonPacked_None)
+    {
+        return JsonType_Float;
+    }
+    
+    return AArrayList_Get(array->valueList, index, JsonValue).type;
+}
+
+
+static int ArrayGetCount(JsonArray* array)
+{
+    return array->valueList->size;
+}
+
+
+static const char* ArrayGetNumberText(JsonArray* array, int index, int* outLength)
+{
+    if (array->packedType != JsonPacked_None)
+    {
+        return NULL;
+    }
+
+    return GetNumberText(&AArrayList_Get(array->valueList, index, JsonValue), outLength);
+}
+
+
+/**
+ * Clamp the count of elements from index that can be copied.
+ */
+static int ArrayGetCopyCount(JsonArray* array, int index, int count)
+{
+    if (index < 0 || count <= 0 || index >= array->valueList->size)
+    {
+        return 0;
+    }
+
+    if (count > array->valueList->size - index)
+    {
+        count = array->valueList->size - index;
+    }
+
+    return count;
+}
+
+
+static int ArrayCopyFloats(JsonArray* array, int index, int count, float* outValues)
+{
+    count = ArrayGetCopyCount(array, index, count);
+
+    if (array->packedType != JsonPacked_None)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            outValues[i] = (float) ArrayGetPackedDouble(array, index + i);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            JsonValue* value = &AArrayList_Get(array->valueList, index + i, JsonValue);
+            outValues[i]     = value->type == JsonType_Float ? GetNumberValue(value) : 0.0f;
+        }
+    }
+
+    return count;
+}
+
+
+static int ArrayCopyDoubles(JsonArray* array, int index, int count, double* outValues)
+{
+    count = ArrayGetCopyCount(array, index, count);
+
+    switch (array->packedType)
+    {
+        case JsonPacked_Double:
+            memcpy(outValues, &AArrayList_Get(array->valueList, index, double), sizeof(double) * count);
+            break;
+
+        case JsonPacked_Int64:
+            for (int i = 0; i < count; ++i)
+            {
+                outValues[i] = (double) AArrayList_Get(array->valueList, index + i, int64_t);
+            }
+            break;
+
+        case JsonPacked_None:
+            for (int i = 0; i < count; ++i)
+            {
+                JsonValue* value = &AArrayList_Get(array->valueList, index + i, JsonValue);
+                outValues[i]     = value->type == JsonType_Float ? GetNumberValue(value) : 0.0;
+            }
+            break;
+    }
+
+    return count;
+}
+
+
+static int ArrayCopyInt64s(JsonArray* array, int index, int count, int64_t* outValues)
+{
+    count = ArrayGetCopyCount(array, index, count);
+
+    switch (array->packedType)
+    {
+        case JsonPacked_Int64:
+            memcpy(outValues, &AArrayList_Get(array->valueList, index, int64_t), sizeof(int64_t) * count);
+            break;
+
+        case JsonPacked_Double:
+            for (int i = 0; i < count; ++i)
+            {
+                outValues[i] = NumberToInt64(AArrayList_Get(array->valueList, index + i, double));
+            }
+            break;
+
+        case JsonPacked_None:
+            for (int i = 0; i < count; ++i)
+            {
+                JsonValue* value = &AArrayList_Get(array->valueList, index + i, JsonValue);
+                outValues[i]     = value->type == JsonType_Float ? NumberToInt64(GetNumberValue(value)) : 0;
+            }
+            break;
+    }
+
+    return count;
+}
+
+
+struct AJsonArray AJsonArray[1] =
+{{
+    ArrayGetBool,
+    ArrayGetInt,
+    ArrayGetFloat,
+    ArrayGetType,
+    ArrayGetString,
+    ArrayGetObject,
+    ArrayGetArray,
+    ArrayGetCount,
+    ArrayCopyFloats,
+    ArrayCopyDoubles,
+    ArrayCopyInt64s,
+    ArrayGetNumberText,
+}};
+
+
+// Json parser
+//----------------------------------------------------------------------------------------------------------------------
+
+
+static void SkipWhiteSpace(const char** jsonPtr)
+{
+    const char* json = *jsonPtr;
+
+    while (true)
+    {
+        switch (*json)
+        {
+            case ' ' :
+            case '\t':
+            case '\n':
+            case '\r':
+                ++json;
+                continue;
+            default:
+                break;
+        }
+        break;
+    }
+
+    *jsonPtr = json;
+}
+
+
+/**
+ * If parser isLazyNumber, the number keeps raw text that converted when first get.
+ */
+static void ParseNumber(JsonParser* parser, const char** jsonPtr, JsonValue* outValue)
+{
+    const char* json = *jsonPtr;
+    outValue->type   = JsonType_Float;
+
+    if (parser->isLazyNumber)
+    {
+        int  length = 0;
+        char c;
+
+        while
+        (
+            ((c = json[length]) >= '0' && c <= '9') ||
+            c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'
+        )
+        {
+            ++length;
+        }
+
+        if (length <= JsonValue_MaxLazyNumber)
+        {
+            outValue->jsonString                                = (char*) json;
+            outValue->reserved[JsonValue_NumberLength]          = (uint8_t) length;
+            outValue->reserved[JsonValue_NumberState]           = JsonNumber_Raw;
+            outValue->jsonShortString[JsonValue_LazyNumberByte] = 1;
+
+            ALog_D("Json number = %.*s", length, json);
+
+            *jsonPtr = json + length;
+            return;
+        }
+    }
+
+    char* endPtr;
+
+    outValue->jsonFloat                                 = strtof(json, &endPtr);
+    outValue->reserved[JsonValue_NumberState]           = JsonNumber_Float;
+    outValue->jsonShortString[JsonValue_LazyNumberByte] = 0;
+
+    ALog_D("Json number = %.*s", (int) (endPtr - json), json);
+    
+    *jsonPtr = endPtr;
+}
+
+
+/**
+ * Skip the string at '"', return the length of string without quotes,
+ * if the json is incomplete return -1, and the *jsonPtr stops at '\0'.
+ */
+static int SkipString(const char** jsonPtr, const char** outStrStart)
+{
+    // skip '"'
+    const char* json  = ++(*jsonPtr);
+    int         count = 0;
+    char        c;
+
+    // check end '"'
+    while ((c = json[count++]) != '"')
+    {
+        if (c == '\\')
+        {
+            // skip escaped quotes
+            // the escape char may be '\"'，which will break while
+            c = json[count++];
+        }
+
+        if (c == '\0')
+        {
+            // the json is incomplete, stop at the '\0'
+            *jsonPtr += count - 1;
+            return -1;
+        }
+    }
+
+    *outStrStart = json;
+    
+    // already skipped the string end '"'
+    *jsonPtr    += count;
+
+    // how many char skipped
+    // count contains the string end '"', so -1
+    return count - 1;
+}
+
+
+/**
+ * Skip one json value without creating JsonValue, the *jsonPtr moves after the value.
+ */
+static void SkipValue(const char** jsonPtr)
+{
+    SkipWhiteSpace(jsonPtr);
+
+    const char* json = *jsonPtr;
+    const char* strStart;
+
+    switch (*json)
+    {
+        case '"':
+            SkipString(jsonPtr, &strStart);
+            return;
+
+        case '{':
+        case '[':
+        {
+            int depth = 0;
+
+            do
+            {
+                switch (*json)
+                {
+                    case '"':
+                        // the string may contains brackets
+                        SkipString(&json, &strStart);
+                        continue;
+
+                    case '{':
+                    case '[':
+                        ++depth;
+                        break;
+
+                    case '}':
+                    case ']':
+                        --depth;
+                        break;
+
+                    case '\0':
+                        // the json is incomplete
+                        *jsonPtr = json;
+                        return;
+
+                    default:
+                        break;
+                }
+
+                ++json;
+            }
+            while (depth > 0);
+
+            break;
+        }
+
+        default:
+            // number, true, false and null end with delimiter
+            while
+            (
+                *json != ','  && *json != '}'  && *json != ']'  && *json != '\0' &&
+                *json != ' '  && *json != '\t' && *json != '\n' && *json != '\r'
+            )
+            {
+                ++json;
+            }
+            break;
+    }
+
+    *jsonPtr = json;
+}
+
+
+/**
+ * If the parser unable to alloc memory return false.
+ */
+static bool ParseString(JsonParser* parser, const char** jsonPtr, JsonValue* outValue)
+{
+    const char* strStart;
+    int         length = SkipString(jsonPtr, &strStart);
+
+    if (length < 0)
+    {
+        ALog_D("Json string parse error, json is incomplete");
+        return ParserFail(parser, JsonParseError_Syntax);
+    }
+
+    if (parser->isDedup && length > JsonValue_ShortStringLength)
+    {
+        if (DedupSetString(parser, strStart, length, outValue) == false)
+        {
+            return false;
+        }
+    }
+    else if (SetStringValue(parser, strStart, length, outValue) == false)
+    {
+        return false;
+    }
+
+    ALog_D("Json string = %s", AJsonValue_GetString(outValue));
+
+    return true;
+}
+
+
+/**
+ * Free the JsonValues in valueStack from base to top, then pop them.
+ */
+static void ParserPopValues(JsonParser* parser, int base)
+{
+    ArrayList* stack = parser->valueStack;
+
+    if (parser->isArena == false)
+    {
+        for (int i = base; i < stack->size; ++i)
+        {
+            DestroyValue(parser->allocator, &AArrayList_Get(stack, i, JsonValue));
+        }
+    }
+
+    stack->size = base;
+}
+
+
+/**
+ * Free the ArrayStrMapElements and values in elementStack from base to top, then pop them.
+ */
+static void ParserPopElements(JsonParser* parser, int base)
+{
+    ArrayList* stack = parser->elementStack;
+
+    if (parser->isArena == false)
+    {
+        for (int i = base; i < stack->size; ++i)
+        {
+            ArrayStrMapElement* element = AArrayList_Get(stack, i, ArrayStrMapElement*);
+            DestroyValue(parser->allocator, element->valuePtr);
+            ParserFree(parser, element);
+        }
+    }
+
+    stack->size = base;
+}
+
+
+// predefine
+static bool ParseValue(JsonParser* parser, const char** jsonPtr, JsonValue* outValue);
+
+
+/**
+ * The wall clock time for parse timing.
+ */
+static inline uint64_t GetNanoseconds(void)
+{
+    struct timespec time[1];
+    timespec_get(time, TIME_UTC);
+
+    return (uint64_t) time->tv_sec * 1000000000u + (uint64_t) time->tv_nsec;
+}
+
+
+/**
+ * Parse the number of array that may be packed,
+ * if the number is integer and not overflow int64_t set outNumber->int64 and return true,
+ * else set outNumber->float64 and return false.
+ */
+static bool ParsePackedNumber(const char** jsonPtr, JsonPackedNumber* outNumber)
+{
+    const char* json   = *jsonPtr;
+    const char* digits = *json == '-' ? json + 1 : json;
+    uint64_t    number = 0;
+    int         count  = 0;
+
+    while (digits[count] >= '0' && digits[count] <= '9')
+    {
+        number = number * 10 + (uint64_t) (digits[count++] - '0');
+    }
+
+    char c = digits[count];
+
+    // 18 digits cannot overflow int64_t
+    if (count > 0 && count <= 18 && c != '.' && c != 'e' && c != 'E')
+    {
+        outNumber->int64 = digits == json ? (int64_t) number : -(int64_t) number;
+        *jsonPtr         = digits + count;
+    }
+    else
+    {
+        char* endPtr;
+        outNumber->float64 = strtod(json, &endPtr);
+        *jsonPtr           = endPtr;
+        count              = 0;
+    }
+
+    ALog_D("Json number = %.*s", (int) (*jsonPtr - json), json);
+
+    return count > 0;
+}
+
+
+/**
+ * Convert the numbers in numberStack from base to top into JsonValues, and push them into valueStack.
+ * if the parser unable to alloc memory return false.
+ */
+static bool ParserUnpackNumbers(JsonParser* parser, int numberBase, bool isInt64)
+{
+    ArrayList* numberStack = parser->numberStack;
+
+    for (int i = numberBase; i < numberStack->size; ++i)
+    {
+        JsonPackedNumber number = AArrayList_Get(numberStack, i, JsonPackedNumber);
+        JsonValue        value[1];
+
+        value->type                                      = JsonType_Float;
+        value->jsonFloat                                 = isInt64 ? (float) number.int64 : (float) number.float64;
+        value->reserved[JsonValue_NumberState]           = JsonNumber_Float;
+        value->jsonShortString[JsonValue_LazyNumberByte] = 0;
+
+        if (AArrayList_Add(parser->allocator, parser->valueStack, *value) == NULL)
+        {
+            return false;
+        }
+    }
+
+    numberStack->size = numberBase;
+
+    return true;
+}
+
+
+/**
+ * If the parser unable to alloc memory return false, and the parsed elements freed.
+ */
+static bool ParseArray(JsonParser* parser, const char** jsonPtr, JsonValue* outValue)
+{
+    // the elements push into stack first, then copy into the exact capacity list
+    ArrayList* stack       = parser->valueStack;
+    int        base        = stack->size;
+
+    // the leading numbers push into numberStack, if all elements are numbers the array will be packed
+    ArrayList* numberStack = parser->numberStack;
+    int        numberBase  = numberStack->size;
+    // the lazy numbers keep raw text, so not packed
+    bool       isPacked    = parser->isLazyNumber == false;
+    bool       isInt64     = true;
+
+    // the memory of array released when it is dedup
+    JsonArenaMark mark = ParserMark(parser);
+
+    ++parser->stats->arrayCount;
+    ALog_D("Json Array: [");
+    
+    // skip '['
+    ++(*jsonPtr);
+
+    do
+    {
+        SkipWhiteSpace(jsonPtr);
+
+        char c = **jsonPtr;
+
+        if (c == ']')
+        {
+            break;
+        }
+
+        if (isPacked && ((c >= '0' && c <= '9') || c == '-'))
+        {
+            JsonPackedNumber number;
+            ++parser->stats->numberCount;
+
+            if (ParsePackedNumber(jsonPtr, &number))
+            {
+                if (isInt64 == false)
+                {
+                    number.float64 = (double) number.int64;
+                }
+            }
+            else if (isInt64)
+            {
+                isInt64 = false;
+
+                // the packed type change to double
+                for (int i = numberBase; i < numberStack->size; ++i)
+                {
+                    JsonPackedNumber* packed = &AArrayList_Get(numberStack, i, JsonPackedNumber);
+                    packed->float64          = (double) packed->int64;
+                }
+            }
+
+            if (AArrayList_Add(parser->allocator, numberStack, number) == NULL)
+            {
+                numberStack->size = numberBase;
+                return false;
+            }
+        }
+        else
+        {
+            if (isPacked)
+            {
+                // not all numbers, so the leading numbers need to be JsonValues
+                isPacked = false;
+
+                if (ParserUnpackNumbers(parser, numberBase, isInt64) == false)
+                {
+                    numberStack->size = numberBase;
+                    ParserPopValues(parser, base);
+                    return false;
+                }
+            }
+
+            JsonValue value[1];
+
+            if (ParseValue(parser, jsonPtr, value) == false)
+            {
+                ParserPopValues(parser, base);
+                return false;
+            }
+
+            // add Array element
+            if (AArrayList_Add(parser->allocator, stack, *value) == NULL)
+            {
+                if (parser->isArena == false)
+                {
+                    DestroyValue(parser->allocator, value);
+                }
+
+                ParserPopValues(parser, base);
+                return false;
+            }
+        }
+         
+        SkipWhiteSpace(jsonPtr);
+
+        if (**jsonPtr == ',')
+        {
+            ++(*jsonPtr);
+        }
+        else if (**jsonPtr == ']')
+        {
+            break;
+        }
+        else
+        {
+            ALog_D("Json Array not has ']', error char = %c", **jsonPtr);
+            numberStack->size = numberBase;
+            ParserPopValues(parser, base);
+            return ParserFail(parser, JsonParseError_Syntax);
+        }
+    }
+    while (true);
+
+    // skip ']'
+    ++(*jsonPtr);
+
+    uint64_t buildTime = parser->isTiming ? GetNanoseconds() : 0;
+
+    ArrayList* fromStack  = stack;
+    int        fromBase   = base;
+    JsonPacked packedType = JsonPacked_None;
+
+    if (isPacked && numberStack->size > numberBase)
+    {
+        packedType = isInt64 ? JsonPacked_Int64 : JsonPacked_Double;
+        fromStack  = numberStack;
+        fromBase   = numberBase;
+    }
+
+    int        count = fromStack->size - fromBase;
+    JsonArray* array = CreateJsonArray(parser, fromStack->elementTypeSize, count);
+
+    if (array == NULL)
+    {
+        numberStack->size = numberBase;
+        ParserPopValues(parser, base);
+        return false;
+    }
+
+    ArrayList* list   = array->valueList;
+    list->size        = count;
+    array->packedType = packedType;
+
+    if (count > 0)
+    {
+        memcpy
+        (
+            list->elementArr->data,
+            (char*) fromStack->elementArr->data + (size_t) fromStack->elementTypeSize * fromBase,
+            (size_t) list->elementTypeSize * count
+        );
+
+        fromStack->size = fromBase;
+    }
+
+    outValue->type      = JsonType_Array;
+    outValue->jsonArray = array;
+
+    if (parser->isHash || parser->isDedup)
+    {
+        // the children hashes computed before
+        array->hash = HashArray(array);
+
+        if (parser->isDedup)
+        {
+            DedupContainer(parser, mark, outValue);
+        }
+    }
+
+    if (parser->isTiming)
+    {
+        parser->stats->buildNanoseconds += GetNanoseconds() - buildTime;
+    }
+
+    ALog_D("] JsonArray element count = %d", outValue->jsonArray->valueList->size);
+    
+    return true;
+}
+
+
+/**
+ * If the parser unable to alloc memory return false, and the parsed k-v pairs freed.
+ */
+static bool ParseObject(JsonParser* parser, const char** jsonPtr, JsonValue* outValue)
+{
+    // the k-v pairs push into stack first, then insert into the exact capacity map
+    ArrayList* stack = parser->elementStack;
+    int        base  = stack->size;
+
+    // the memory of object released when it is dedup
+    JsonArenaMark mark = ParserMark(parser);
+
+    ++parser->stats->objectCount;
+    ALog_D("Json Object: {");
+    
+    // skip '{'
+    ++(*jsonPtr);
+
+    do
+    {
+        SkipWhiteSpace(jsonPtr);
+
+        if (**jsonPtr == '}')
+        {
+            break;
+        }
+        
+        if (**jsonPtr != '"')
+        {
+            ALog_D("Json object parse error, char = %c, should be '\"'", **jsonPtr);
+            ParserPopElements(parser, base);
+            return ParserFail(parser, JsonParseError_Syntax);
+        }
+
+        ++parser->stats->keyCount;
+
+        const char* strStart;
+        int         keyLen = SkipString(jsonPtr, &strStart);
+        const char* key    = NULL;
+
+        if (keyLen < 0)
+        {
+            ALog_D("Json object parse error, key is incomplete");
+            ParserPopElements(parser, base);
+            return ParserFail(parser, JsonParseError_Syntax);
+        }
+
+        if (parser->keyPool != NULL)
+        {
+            // the key stored once in pool, or in element space when pool not stores it
+            const JsonKey* poolKey = KeyPoolIntern(parser->keyPool, strStart, keyLen);
+
+            if (poolKey != NULL)
+            {
+                key = poolKey->key;
+            }
+        }
+
+        // the key (if not in pool) and value in element space
+        ArrayStrMapElement* element = ParserAlloc
+                                      (
+                                          parser,
+                                          sizeof(ArrayStrMapElement) + sizeof(JsonValue) +
+                                          (key != NULL ? 0 : keyLen + 1)
+                                      );
+
+        if (element == NULL || AArrayList_Add(parser->allocator, stack, element) == NULL)
+        {
+            ParserFree(parser, element);
+            ParserPopElements(parser, base);
+            return false;
+        }
+
+        element->keyLength = keyLen + 1;
+        element->valuePtr  = (char*) element + sizeof(ArrayStrMapElement);
+
+        if (key != NULL)
+        {
+            element->key = key;
+        }
+        else
+        {
+            element->key = (char*) element->valuePtr + sizeof(JsonValue);
+            memcpy((void*) element->key, strStart, (size_t) keyLen);
+            // make string end
+            ((char*) element->key)[keyLen] = '\0';
+        }
+
+        // the value not parsed yet, so it frees nothing when pop
+        ((JsonValue*) element->valuePtr)->type = JsonType_Null;
+
+        ALog_D("Json key = %s", element->key);
+
+        SkipWhiteSpace(jsonPtr);
+
+        if (**jsonPtr != ':')
+        {
+            ALog_D("Json object parse error, char = %c, should be ':'", **jsonPtr);
+            ParserPopElements(parser, base);
+            return ParserFail(parser, JsonParseError_Syntax);
+        }
+
+        // skip ':'
+        ++(*jsonPtr);
+
+        // the failed ParseValue not changes value
+        if (ParseValue(parser, jsonPtr, element->valuePtr) == false)
+        {
+            ParserPopElements(parser, base);
+            return false;
+        }
+
+        SkipWhiteSpace(jsonPtr);
+
+        if (**jsonPtr == ',')
+        {
+            ++(*jsonPtr);
+        }
+        else if (**jsonPtr == '}')
+        {
+            break;
+        }
+        else
+        {
+            ALog_D("Json Object not has '}', error char = %c", **jsonPtr);
+            ParserPopElements(parser, base);
+            return ParserFail(parser, JsonParseError_Syntax);
+        }
+    }
+    while (true);
+
+    // skip '}'
+    ++(*jsonPtr);
+
+    uint64_t buildTime = parser->isTiming ? GetNanoseconds() : 0;
+
+    int         count  = stack->size - base;
+    JsonObject* object = CreateJsonObject(parser, count);
+
+    if (object == NULL)
+    {
+        ParserPopElements(parser, base);
+        return false;
+    }
+
+    ArrayStrMap* map = object->valueMap;
+
+    for (int i = base; i < stack->size; ++i)
+    {
+        ArrayStrMapElement* element = AArrayList_Get(stack, i, ArrayStrMapElement*);
+
+        // set object element, the first one wins when key repeated,
+        // and the capacity is enough so only fail on repeated key
+        if (ArrayStrMapTryInsert(parser->allocator, map, element) == false)
+        {
+            if (parser->isArena == false)
+            {
+                DestroyValue(parser->allocator, element->valuePtr);
+            }
+
+            ParserFree(parser, element);
+        }
+    }
+
+    stack->size          = base;
+    outValue->type       = JsonType_Object;
+    outValue->jsonObject = object;
+
+    if (parser->isHash || parser->isDedup)
+    {
+        // the children hashes computed before
+        object->hash = HashObject(object);
+
+        if (parser->isDedup)
+        {
+            DedupContainer(parser, mark, outValue);
+        }
+    }
+
+    if (parser->isTiming)
+    {
+        parser->stats->buildNanoseconds += GetNanoseconds() - buildTime;
+    }
+
+    ALog_D("} JsonObject elements count = %d", outValue->jsonObject->valueMap->elementList->size);
+
+    return true;
+}
+
+
+/**
+ * ParseValue changed the *jsonPtr, so if *jsonPtr is direct malloc will cause error.
+ * if the parser unable to alloc memory return false.
+ */
+static bool ParseValue(JsonParser* parser, const char** jsonPtr, JsonValue* outValue)
+{
+    SkipWhiteSpace(jsonPtr);
+
+    char c = **jsonPtr;
+
+    switch (c)
+    {
+        case '{':
+        case '[':
+        {
+            // the depth limit also bounds the recursion
+            if (parser->depth == parser->limits->maxDepth)
+            {
+                ALog_D("Json depth over limit = %d", parser->limits->maxDepth);
+                return ParserFail(parser, JsonParseError_MaxDepth);
+            }
+
+            if (++parser->depth > parser->stats->maxDepth)
+            {
+                parser->stats->maxDepth = parser->depth;
+            }
+
+            bool isOk = c == '{' ? ParseObject(parser, jsonPtr, outValue) : ParseArray(parser, jsonPtr, outValue);
+            --parser->depth;
+
+            return isOk;
+        }
+
+        case '"':
+            ++parser->stats->stringCount;
+            return ParseString(parser, jsonPtr, outValue);
+
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '-':
+            ++parser->stats->numberCount;
+            ParseNumber(parser, jsonPtr, outValue);
+            return true;
+
+        case 'f':
+        {
+            const char* json = *jsonPtr;
+
+            if
+            (
+                json[1] == 'a' &&
+                json[2] == 'l' &&
+                json[3] == 's' &&
+                json[4] == 'e'
+            )
+            {
+                ALog_D("Json false");
+                ++parser->stats->literalCount;
+
+                (*jsonPtr) += 5;
+
+                // the short string no need alloc
+                return SetStringValue(parser, "false", 5, outValue);
+            }
+            break;
+        }
+
+        case 't':
+        {
+            const char* json = *jsonPtr;
+
+            if
+            (
+                json[1] == 'r' &&
+                json[2] == 'u' &&
+                json[3] == 'e'
+            )
+            {
+                ALog_D("Json true");
+                ++parser->stats->literalCount;
+
+                (*jsonPtr) += 4;
+
+                // the short string no need alloc
+                return SetStringValue(parser, "true", 4, outValue);
+            }
+            break;
+        }
+
+        case 'n':
+        {
+            const char* json = *jsonPtr;
+
+            if
+            (
+                json[1] == 'u' &&
+                json[2] == 'l' &&
+                json[3] == 'l'
+            )
+            {
+                ALog_D("Json null");
+                ++parser->stats->literalCount;
+
+                (*jsonPtr) += 4;
+
+                // the short string no need alloc
+                return SetStringValue(parser, "null", 4, outValue);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    ALog_D("Invalid json value type, error char = %c", c);
+
+    return ParserFail(parser, JsonParseError_Syntax);
+}
+
+
+/**
+ * Alloc the root JsonValue then parse into it, and the stats of parser filled.
+ * the length is the bytes of complete json value not end with '\0', or SIZE_MAX that jsonString ends with '\0'.
+ *
+ * if the parser unable to alloc memory, the json invalid or over the limits return NULL.
+ */
+static JsonValue* ParseRoot(JsonParser* parser, const char* jsonString, size_t length)
+{
+    JsonParseStats* stats = parser->stats;
+
+    memset(stats, 0, sizeof(JsonParseStats));
+    parser->depth = 0;
+
+    // the memchr stops at '\0', so not read over the short json string
+    if
+    (
+        parser->limits->maxBytes != SIZE_MAX &&
+        (
+            length != SIZE_MAX ?
+            length > parser->limits->maxBytes :
+            memchr(jsonString, '\0', parser->limits->maxBytes + 1) == NULL
+        )
+    )
+    {
+        ALog_D("Json bytes over limit = %zu", parser->limits->maxBytes);
+        ParserFail(parser, JsonParseError_MaxBytes);
+        return NULL;
+    }
+
+    uint64_t    startTime = parser->isTiming ? GetNanoseconds() : 0;
+    const char* json      = jsonString;
+    JsonValue*  value     = ParserAlloc(parser, sizeof(JsonValue));
+
+    if (value != NULL && ParseValue(parser, &json, value) == false)
+    {
+        ParserFree(parser, value);
+        value = NULL;
+    }
+
+    if (value == NULL)
+    {
+        // the other errors set where they fail
+        ParserFail(parser, JsonParseError_Memory);
+    }
+
+    stats->bytes = (size_t) (json - jsonString);
+
+    if (parser->isTiming)
+    {
+        stats->scanNanoseconds = GetNanoseconds() - startTime - stats->buildNanoseconds;
+    }
+
+    return value;
+}
+
+
+static JsonValue* Parse(const char* jsonString)
+{
+    // the stacks only live in one Parse
+    JsonParser parser[1];
+    ParserInit(defaultAllocator, false, parser);
+
+    JsonValue* value = ParseRoot(parser, jsonString, SIZE_MAX);
+    ParserRelease(parser);
+
+    return value;
+}
+
+
+static JsonValue* ParseAndGetStats(const char* jsonString, JsonParseStats* outStats)
+{
+    JsonParser parser[1];
+    ParserInit(defaultAllocator, false, parser);
+    ParserCountAllocator(parser);
+
+    JsonValue* value = ParseRoot(parser, jsonString, SIZE_MAX);
+    ParserRelease(parser);
+    *outStats = *parser->stats;
+
+    return value;
+}
+
+
+static char* GetString(JsonValue* jsonValue)
+{
+    return AJsonValue_GetString(jsonValue);
+}
+
+
+static float GetFloat(JsonValue* jsonValue)
+{
+    return GetNumberValue(jsonValue);
+}
+
+
+static JsonParser* CreateParser(const JsonAllocator* allocator)
+{
+    if (allocator == NULL)
+    {
+        allocator = defaultAllocator;
+    }
+
+    JsonParser* parser = allocator->Alloc(allocator->context, sizeof(JsonParser));
+
+    if (parser != NULL)
+    {
+        ParserInit(allocator, true, parser);
+        ParserCountAllocator(parser);
+    }
+
+    return parser;
+}
+
+
+static JsonValue* ParseWith(JsonParser* parser, const char* jsonString)
+{
+    return ParseRoot(parser, jsonString, SIZE_MAX);
+}
+
+
+static void Reset(JsonParser* parser)
+{
+    for (JsonArenaBlock* block = parser->firstBlock; block != NULL; block = block->next)
+    {
+        block->used = 0;
+    }
+
+    parser->currentBlock       = parser->firstBlock;
+    parser->valueStack->size   = 0;
+    parser->elementStack->size = 0;
+    parser->numberStack->size  = 0;
+
+    if (parser->dedupCount > 0)
+    {
+        // the stored values released
+        memset(parser->dedupTable, 0, sizeof(JsonDedupEntry) * parser->dedupCapacity);
+        parser->dedupCount = 0;
+    }
+
+    parser->dedupStats->dedupCount = 0;
+    parser->dedupStats->savedBytes = 0;
+}
+
+
+static void DestroyParser(JsonParser* parser)
+{
+    // copy allocator before free parser
+    JsonAllocator allocator[1] = {*parser->userAllocator};
+
+    ParserRelease(parser);
+    allocator->Free(allocator->context, parser);
+}
+
+
+static void SetLazyNumber(JsonParser* parser, bool isLazyNumber)
+{
+    parser->isLazyNumber = isLazyNumber;
+}
+
+
+static void SetHash(JsonParser* parser, bool isHash)
+{
+    parser->isHash = isHash;
+}
+
+
+static void SetDedup(JsonParser* parser, bool isDedup)
+{
+    parser->isDedup = isDedup;
+}
+
+
+static void GetDedupStats(JsonParser* parser, JsonDedupStats* outStats)
+{
+    *outStats = *parser->dedupStats;
+}
+
+
+static void SetKeyPool(JsonParser* parser, JsonKeyPool* keyPool)
+{
+    parser->keyPool = keyPool;
+}
+
+
+static void SetLimits(JsonParser* parser, const JsonParseLimits* limits)
+{
+    ParserSetLimits(parser, limits);
+}
+
+
+static void SetParseTiming(JsonParser* parser, bool isTiming)
+{
+    parser->isTiming = isTiming;
+}
+
+
+static void GetParseStats(JsonParser* parser, JsonParseStats* outStats)
+{
+    *outStats = *parser->stats;
+}
+
+
+static void SetTrace(JsonTrace callback, void* context)
+{
+#ifdef JSON_TRACE
+    traceCallback = callback;
+    traceContext  = context;
+#else
+    (void) callback;
+    (void) context;
+#endif
+}
+
+
+static uint64_t GetHash(JsonValue* jsonValue)
+{
+    return GetValueHash(jsonValue);
+}
+
+
+static bool Equals(JsonValue* a, JsonValue* b)
+{
+    if (a->type != b->type)
+    {
+        return false;
+    }
+
+    switch (a->type)
+    {
+        case JsonType_Array:
+        {
+            JsonArray* arrayA = a->jsonArray;
+            JsonArray* arrayB = b->jsonArray;
+
+            // the same hash may collide, so only the different hash decides
+            if (arrayA->hash != 0 && arrayB->hash != 0 && arrayA->hash != arrayB->hash)
+            {
+                return false;
+            }
+
+            if (arrayA->valueList->size != arrayB->valueList->size)
+            {
+                return false;
+            }
+
+            // the -0 and 0 of double have different bits
+            if (arrayA->packedType == JsonPacked_Int64 && arrayB->packedType == JsonPacked_Int64)
+            {
+                return memcmp
+                       (
+                           arrayA->valueList->elementArr->data,
+                           arrayB->valueList->elementArr->data,
+                           (size_t) arrayA->valueList->elementTypeSize * arrayA->valueList->size
+                       )
+                       == 0;
+            }
+
+            for (int i = 0; i < arrayA->valueList->size; ++i)
+            {
+                if (arrayA->packedType == JsonPacked_None && arrayB->packedType == JsonPacked_None)
+                {
+                    JsonValue* valueA = &AArrayList_Get(arrayA->valueList, i, JsonValue);
+                    JsonValue* valueB = &AArrayList_Get(arrayB->valueList, i, JsonValue);
+
+                    if (Equals(valueA, valueB) == false)
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    JsonExactNumber numberA;
+                    JsonExactNumber numberB;
+
+                    if
+                    (
+                        ArrayGetExactNumber(arrayA, i, &numberA) == false ||
+                        ArrayGetExactNumber(arrayB, i, &numberB) == false ||
+                        ExactNumberEquals(&numberA, &numberB)    == false
+                    )
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        case JsonType_Object:
+        {
+            JsonObject* objectA = a->jsonObject;
+            JsonObject* objectB = b->jsonObject;
+            ArrayList*  list    = objectA->valueMap->elementList;
+
+            if (objectA->hash != 0 && objectB->hash != 0 && objectA->hash != objectB->hash)
+            {
+                return false;
+            }
+
+            if (list->size != objectB->valueMap->elementList->size)
+            {
+                return false;
+            }
+
+            for (int i = 0; i < list->size; ++i)
+            {
+                ArrayStrMapElement* element = AArrayList_Get(list, i, ArrayStrMapElement*);
+                JsonValue*          value   = AArrayStrMap_Get(objectB->valueMap, element->key, JsonValue);
+
+                if (value == NULL || Equals(element->valuePtr, value) == false)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        case JsonType_String:
+            return strcmp(AJsonValue_GetString(a), AJsonValue_GetString(b)) == 0;
+
+        case JsonType_Float:
+        {
+            JsonExactNumber numberA;
+            JsonExactNumber numberB;
+
+            GetExactNumber(a, &numberA);
+            GetExactNumber(b, &numberB);
+
+            return ExactNumberEquals(&numberA, &numberB);
+        }
+
+        default:
+            return true;
+    }
+}
+
+
+/**
+ * Push "/" and segment into path that keeps '\0' at the end, the '~' and '/' of segment escaped as "~0" and "~1".
+ * if unable to alloc memory return false.
+ */
+static bool DiffPushPath(ArrayList* path, const char* segment)
+{
+    // overwrite the '\0'
+    --path->size;
+
+    char c = '/';
+
+    if (AArrayList_Add(defaultAllocator, path, c) == NULL)
+    {
+        return false;
+    }
+
+    for (; *segment != '\0'; ++segment)
+    {
+        char escape = *segment == '~' ? '0' : *segment == '/' ? '1' : '\0';
+        c           = escape != '\0' ? '~' : *segment;
+
+        if
+        (
+            AArrayList_Add(defaultAllocator, path, c) == NULL ||
+            (escape != '\0' && AArrayList_Add(defaultAllocator, path, escape) == NULL)
+        )
+        {
+            return false;
+        }
+    }
+
+    c = '\0';
+
+    return AArrayList_Add(defaultAllocator, path, c) != NULL;
+}
+
+
+/**
+ * Pop path to size and keep '\0' at the end.
+ */
+static void DiffPopPath(ArrayList* path, int size)
+{
+    path->size                           = size;
+    AArrayList_Get(path, size - 1, char) = '\0';
+}
+
+
+// predefine
+static int DiffValue
+(
+    ArrayList* path,
+    JsonValue* oldValue,
+    JsonValue* newValue,
+    void     (*OnDiff)(void* context, const char* path, JsonValue* oldValue, JsonValue* newValue),
+    void*      context
+);
+
+
+/**
+ * Diff the JsonArrays that not packed by index.
+ */
+static int DiffArray
+(
+    ArrayList* path,
+    JsonArray* oldArray,
+    JsonArray* newArray,
+    void     (*OnDiff)(void* context, const char* path, JsonValue* oldValue, JsonValue* newValue),
+    void*      context
+)
+{
+    int size  = path->size;
+    int count = 0;
+    int max   = oldArray->valueList->size > newArray->valueList->size ?
+                oldArray->valueList->size : newArray->valueList->size;
+
+    for (int i = 0; i < max; ++i)
+    {
+        char segment[12];
+        snprintf(segment, sizeof(segment), "%d", i);
+
+        if (DiffPushPath(path, segment) == false)
+        {
+            return -1;
+        }
+
+        JsonValue* oldValue = i < oldArray->valueList->size ? &AArrayList_Get(oldArray->valueList, i, JsonValue) : NULL;
+        JsonValue* newValue = i < newArray->valueList->size ? &AArrayList_Get(newArray->valueList, i, JsonValue) : NULL;
+        int        diff     = 1;
+
+        if (oldValue != NULL && newValue != NULL)
+        {
+            diff = DiffValue(path, oldValue, newValue, OnDiff, context);
+        }
+        else
+        {
+            OnDiff(context, path->elementArr->data, oldValue, newValue);
+        }
+
+        if (diff < 0)
+        {
+            return -1;
+        }
+
+        count += diff;
+        DiffPopPath(path, size);
+    }
+
+    return count;
+}
+
+
+/**
+ * Diff the JsonObjects by key.
+ */
+static int DiffObject
+(
+    ArrayList*  path,
+    JsonObject* oldObject,
+    JsonObject* newObject,
+    void      (*OnDiff)(void* context, const char* path, JsonValue* oldValue, JsonValue* newValue),
+    void*       context
+)
+{
+    int        size    = path->size;
+    int        count   = 0;
+    ArrayList* oldList = oldObject->valueMap->elementList;
+    ArrayList* newList = newObject->valueMap->elementList;
+
+    for (int i = 0; i < oldList->size; ++i)
+    {
+        ArrayStrMapElement* element  = AArrayList_Get(oldList, i, ArrayStrMapElement*);
+        JsonValue*          newValue = AArrayStrMap_Get(newObject->valueMap, element->key, JsonValue);
+        int                 diff     = 1;
+
+        if (DiffPushPath(path, element->key) == false)
+        {
+            return -1;
+        }
+
+        if (newValue != NULL)
+        {
+            diff = DiffValue(path, element->valuePtr, newValue, OnDiff, context);
+        }
+        else
+        {
+            // the key removed
+            OnDiff(context, path->elementArr->data, element->valuePtr, NULL);
+        }
+
+        if (diff < 0)
+        {
+            return -1;
+        }
+
+        count += diff;
+        DiffPopPath(path, size);
+    }
+
+    for (int i = 0; i < newList->size; ++i)
+    {
+        ArrayStrMapElement* element = AArrayList_Get(newList, i, ArrayStrMapElement*);
+
+        if (AArrayStrMap_Get(oldObject->valueMap, element->key, JsonValue) == NULL)
+        {
+            if (DiffPushPath(path, element->key) == false)
+            {
+                return -1;
+            }
+
+            // the key added
+            OnDiff(context, path->elementArr->data, NULL, element->valuePtr);
+            DiffPopPath(path, size);
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+
+/**
+ * If the hashes of JsonArray or JsonObject are same, skip the subtree.
+ */
+static int DiffValue
+(
+    ArrayList* path,
+    JsonValue* oldValue,
+    JsonValue* newValue,
+    void     (*OnDiff)(void* context, const char* path, JsonValue* oldValue, JsonValue* newValue),
+    void*      context
+)
+{
+    if (oldValue->type == newValue->type)
+    {
+        if (oldValue->type == JsonType_Object)
+        {
+            if (oldValue->jsonObject->hash != 0 && oldValue->jsonObject->hash == newValue->jsonObject->hash)
+            {
+                return 0;
+            }
+
+            return DiffObject(path, oldValue->jsonObject, newValue->jsonObject, OnDiff, context);
+        }
+
+        if
+        (
+            oldValue->type                  == JsonType_Array   &&
+            oldValue->jsonArray->packedType == JsonPacked_None &&
+            newValue->jsonArray->packedType == JsonPacked_None
+        )
+        {
+            if (oldValue->jsonArray->hash != 0 && oldValue->jsonArray->hash == newValue->jsonArray->hash)
+            {
+                return 0;
+            }
+
+            return DiffArray(path, oldValue->jsonArray, newValue->jsonArray, OnDiff, context);
+        }
+
+        if (Equals(oldValue, newValue))
+        {
+            return 0;
+        }
+    }
+
+    OnDiff(context, path->elementArr->data, oldValue, newValue);
+
+    return 1;
+}
+
+
+static int Diff
+(
+    JsonValue* oldValue,
+    JsonValue* newValue,
+    void     (*OnDiff)(void* context, const char* path, JsonValue* oldValue, JsonValue* newValue),
+    void*      context
+)
+{
+    ArrayList path[1];
+    ArrayListInit(sizeof(char), path);
+
+    char c = '\0';
+    int  count;
+
+    // the root path is ""
+    if (AArrayList_Add(defaultAllocator, path, c) == NULL)
+    {
+        count = -1;
+    }
+    else
+    {
+        count = DiffValue(path, oldValue, newValue, OnDiff, context);
+    }
+
+    ArrayListRelease(defaultAllocator, path);
+
+    return count;
+}
+
+
+struct AJson AJson[1] =
+{{
+    Parse,
+    ParseAndGetStats,
+    Destroy,
+    DestroyDeferred,
+    ReclaimDeferred,
+    GetString,
+    GetFloat,
+    CreateParser,
+    ParseWith,
+    Reset,
+    DestroyParser,
+    SetLazyNumber,
+    SetHash,
+    GetHash,
+    Equals,
+    Diff,
+    SetDedup,
+    GetDedupStats,
+    SetKeyPool,
+    SetLimits,
+    SetParseTiming,
+    GetParseStats,
+    SetTrace,
+}};
+
+
+// JsonDoc shared document
+//----------------------------------------------------------------------------------------------------------------------
+
+
+struct JsonDoc
+{
+    /**
+     * The frozen root JsonValue.
+     */
+    JsonValue*  root;
+
+    /**
+     * When count down to 0 free the root and doc.
+     */
+    atomic_int  referenceCount;
+};
+
+
+/**
+ * Readers pin the slot by increasing the reader count of the current epoch,
+ * so the writer knows when no reader can still hold the old doc pointer without reference.
+ */
+struct JsonDocSlot
+{
+    _Atomic(JsonDoc*) doc;
+
+    /**
+     * The low bit selects which readerCounts new readers increase.
+     */
+    atomic_uint       epoch;
+
+    /**
+     * The readers count of even and odd epoch that in the middle of Acquire.
+     */
+    atomic_int        readerCounts[2];
+
+    /**
+     * Serialize the writers of Publish.
+     */
+    atomic_flag       writerLock;
+};
+
+
+static JsonDoc* DocCreate(JsonValue* root)
+{
+    JsonDoc* doc = malloc(sizeof(JsonDoc));
+
+    if (doc != NULL)
+    {
+        doc->root = root;
+        atomic_init(&doc->referenceCount, 1);
+    }
+
+    return doc;
+}
+
+
+static JsonDoc* DocRetain(JsonDoc* doc)
+{
+    // the caller already holds a reference, so no ordering needed
+    atomic_fetch_add_explicit(&doc->referenceCount, 1, memory_order_relaxed);
+    return doc;
+}
+
+
+static void DocRelease(JsonDoc* doc)
+{
+    if (atomic_fetch_sub_explicit(&doc->referenceCount, 1, memory_order_acq_rel) == 1)
+    {
+        Destroy(doc->root);
+        free(doc);
+    }
+}
+
+
+static JsonValue* DocGetRoot(JsonDoc* doc)
+{
+    return doc->root;
+}
+
+
+static JsonDocSlot* DocCreateSlot(JsonDoc* doc)
+{
+    JsonDocSlot* slot = malloc(sizeof(JsonDocSlot));
+
+    if (slot != NULL)
+    {
+        atomic_init(&slot->doc,             doc);
+        atomic_init(&slot->epoch,           0);
+        atomic_init(&slot->readerCounts[0], 0);
+        atomic_init(&slot->readerCounts[1], 0);
+        atomic_flag_clear(&slot->writerLock);
+    }
+
+    return slot;
+}
+
+
+static void DocDestroySlot(JsonDocSlot* slot)
+{
+    JsonDoc* doc = atomic_load(&slot->doc);
+
+    if (doc != NULL)
+    {
+        DocRelease(doc);
+    }
+
+    free(slot);
+}
+
+
+static JsonDoc* DocAcquire(JsonDocSlot* slot)
+{
+    atomic_int* readerCount = slot->readerCounts + (atomic_load(&slot->epoch) & 1);
+
+    atomic_fetch_add(readerCount, 1);
+
+    // between pin and unpin the writer cannot release the doc we loaded
+    JsonDoc* doc = atomic_load(&slot->doc);
+
+    if (doc != NULL)
+    {
+        DocRetain(doc);
+    }
+
+    atomic_fetch_sub(readerCount, 1);
+
+    return doc;
+}
+
+
+/**
+ * Flip epoch then wait the readers of the old epoch finish,
+ * new readers increase the other count, so the old count always drains.
+ */
+static void DocSlotWaitReaders(JsonDocSlot* slot)
+{
+    atomic_int* readerCount = slot->readerCounts + (atomic_fetch_add(&slot->epoch, 1) & 1);
+
+    while (atomic_load(readerCount) != 0)
+    {
+        // the reader only holds count for a few instructions
+    }
+}
+
+
+static void DocPublish(JsonDocSlot* slot, JsonDoc* doc)
+{
+    while (atomic_flag_test_and_set_explicit(&slot->writerLock, memory_order_acquire))
+    {
+        // wait other writer
+    }
+
+    JsonDoc* oldDoc = atomic_exchange(&slot->doc, doc);
+
+    // a reader may pin with an epoch read long ago,
+    // so wait both counts to drain once after the exchange
+    DocSlotWaitReaders(slot);
+    DocSlotWaitReaders(slot);
+
+    atomic_flag_clear_explicit(&slot->writerLock, memory_order_release);
+
+    if (oldDoc != NULL)
+    {
+        DocRelease(oldDoc);
+    }
+}
+
+
+struct AJsonDoc AJsonDoc[1] =
+{{
+    DocCreate,
+    DocRetain,
+    DocRelease,
+    DocGetRoot,
+    DocCreateSlot,
+    DocDestroySlot,
+    DocAcquire,
+    DocPublish,
+}};
+
+
+
+// JsonCache content-addressed parse cache
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The min capacity of buckets, and the buckets double when count more than capacity.
+ */
+#define JsonCache_MinCapacity 64
+
+
+/**
+ * The cached doc that the copy of json string follows the entry.
+ */
+typedef struct JsonCacheEntry JsonCacheEntry;
+struct JsonCacheEntry
+{
+    uint64_t        hash;
+    size_t          length;
+    JsonDoc*        doc;
+
+    /**
+     * The bytes counted in budget, include entry, json copy and JsonValues.
+     */
+    size_t          bytes;
+
+    /**
+     * The next entry of same bucket.
+     */
+    JsonCacheEntry* next;
+
+    /**
+     * The LRU list, the head is most recently used.
+     */
+    JsonCacheEntry* lruPrev;
+    JsonCacheEntry* lruNext;
+};
+
+
+struct JsonCache
+{
+    size_t           maxBytes;
+
+    /**
+     * The capacity is power of 2.
+     */
+    JsonCacheEntry** buckets;
+    int              capacity;
+
+    JsonCacheEntry*  lruHead;
+    JsonCacheEntry*  lruTail;
+
+    JsonCacheStats   stats[1];
+
+    /**
+     * Guard the buckets, LRU list and stats, the parse not in lock.
+     */
+    atomic_flag      lock;
+};
+
+
+/**
+ * Hash 8 bytes per step, much faster than FNV-1a on the long json.
+ */
+static uint64_t CacheHash(const char* data, size_t length)
+{
+    uint64_t hash = JsonHash_Seed ^ length;
+    uint64_t word;
+
+    for (; length >= sizeof(uint64_t); data += sizeof(uint64_t), length -= sizeof(uint64_t))
+    {
+        memcpy(&word, data, sizeof(uint64_t));
+        hash  = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 32;
+    }
+
+    word = 0;
+    memcpy(&word, data, length);
+
+    return HashMix(hash ^ word);
+}
+
+
+static inline void CacheLock(JsonCache* cache)
+{
+    while (atomic_flag_test_and_set_explicit(&cache->lock, memory_order_acquire))
+    {
+        // the lock only holds for lookup and insert
+    }
+}
+
+
+static inline void CacheUnlock(JsonCache* cache)
+{
+    atomic_flag_clear_explicit(&cache->lock, memory_order_release);
+}
+
+
+/**
+ * Count the memory of parsed JsonValues, the stacks of parser use Realloc so not counted.
+ */
+static void* CacheCountAlloc(void* context, size_t size)
+{
+    *(size_t*) context += size;
+    return malloc(size);
+}
+
+
+static void* CacheCountRealloc(void* context, void* ptr, size_t size)
+{
+    (void) context;
+    return realloc(ptr, size);
+}
+
+
+static void CacheCountFree(void* context, void* ptr)
+{
+    (void) context;
+    free(ptr);
+}
+
+
+static void CacheLruRemove(JsonCache* cache, JsonCacheEntry* entry)
+{
+    if (entry->lruPrev != NULL)
+    {
+        entry->lruPrev->lruNext = entry->lruNext;
+    }
+    else
+    {
+        cache->lruHead = entry->lruNext;
+    }
+
+    if (entry->lruNext != NULL)
+    {
+        entry->lruNext->lruPrev = entry->lruPrev;
+    }
+    else
+    {
+        cache->lruTail = entry->lruPrev;
+    }
+}
+
+
+static void CacheLruAddHead(JsonCache* cache, JsonCacheEntry* entry)
+{
+    entry->lruPrev = NULL;
+    entry->lruNext = cache->lruHead;
+
+    if (cache->lruHead != NULL)
+    {
+        cache->lruHead->lruPrev = entry;
+    }
+    else
+    {
+        cache->lruTail = entry;
+    }
+
+    cache->lruHead = entry;
+}
+
+
+/**
+ * Find the entry of same json bytes, if not found return NULL.
+ */
+static JsonCacheEntry* CacheFind(JsonCache* cache, uint64_t hash, const char* json, size_t length)
+{
+    JsonCacheEntry* entry = cache->buckets[hash & (uint64_t) (cache->capacity - 1)];
+
+    for (; entry != NULL; entry = entry->next)
+    {
+        // the bytes compared, so the hash collision never returns other doc
+        if (entry->hash == hash && entry->length == length && memcmp(entry + 1, json, length) == 0)
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Remove entry from buckets and LRU list, and release the reference of cache.
+ */
+static void CacheRemove(JsonCache* cache, JsonCacheEntry* entry)
+{
+    JsonCacheEntry** link = cache->buckets + (entry->hash & (uint64_t) (cache->capacity - 1));
+
+    while (*link != entry)
+    {
+        link = &(*link)->next;
+    }
+
+    *link = entry->next;
+    CacheLruRemove(cache, entry);
+
+    --cache->stats->docCount;
+    cache->stats->usedBytes -= entry->bytes;
+
+    // the doc freed when the callers released it
+    DocRelease(entry->doc);
+    free(entry);
+}
+
+
+/**
+ * Double the buckets, if unable to alloc memory keep the old buckets.
+ */
+static void CacheGrow(JsonCache* cache)
+{
+    int              capacity = cache->capacity * 2;
+    JsonCacheEntry** buckets  = calloc((size_t) capacity, sizeof(JsonCacheEntry*));
+
+    if (buckets == NULL)
+    {
+        return;
+    }
+
+    for (int i = 0; i < cache->capacity; ++i)
+    {
+        JsonCacheEntry* entry = cache->buckets[i];
+
+        while (entry != NULL)
+        {
+            JsonCacheEntry*  next = entry->next;
+            JsonCacheEntry** link = buckets + (entry->hash & (uint64_t) (capacity - 1));
+
+            entry->next = *link;
+            *link       = entry;
+            entry       = next;
+        }
+    }
+
+    free(cache->buckets);
+    cache->buckets  = buckets;
+    cache->capacity = capacity;
+}
+
+
+static JsonCache* CacheCreate(size_t maxBytes)
+{
+    JsonCache* cache = malloc(sizeof(JsonCache));
+
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    cache->buckets = calloc(JsonCache_MinCapacity, sizeof(JsonCacheEntry*));
+
+    if (cache->buckets == NULL)
+    {
+        free(cache);
+        return NULL;
+    }
+
+    cache->maxBytes = maxBytes;
+    cache->capacity = JsonCache_MinCapacity;
+    cache->lruHead  = NULL;
+    cache->lruTail  = NULL;
+
+    memset(cache->stats, 0, sizeof(JsonCacheStats));
+    atomic_flag_clear(&cache->lock);
+
+    return cache;
+}
+
+
+static void CacheDestroy(JsonCache* cache)
+{
+    while (cache->lruHead != NULL)
+    {
+        CacheRemove(cache, cache->lruHead);
+    }
+
+    free(cache->buckets);
+    free(cache);
+}
+
+
+static JsonDoc* CacheParse(JsonCache* cache, const char* jsonString)
+{
+    size_t   length = strlen(jsonString);
+    uint64_t hash   = CacheHash(jsonString, length);
+
+    CacheLock(cache);
+
+    JsonCacheEntry* entry = CacheFind(cache, hash, jsonString, length);
+
+    if (entry != NULL)
+    {
+        CacheLruRemove (cache, entry);
+        CacheLruAddHead(cache, entry);
+        ++cache->stats->hitCount;
+
+        JsonDoc* doc = DocRetain(entry->doc);
+        CacheUnlock(cache);
+
+        return doc;
+    }
+
+    ++cache->stats->missCount;
+    CacheUnlock(cache);
+
+    // parse outside lock, and count the memory of JsonValues
+    size_t        valueBytes   = 0;
+    JsonAllocator allocator[1] = {{CacheCountAlloc, CacheCountRealloc, CacheCountFree, &valueBytes}};
+    JsonParser    parser[1];
+
+    ParserInit(allocator, false, parser);
+    JsonValue* root = ParseRoot(parser, jsonString, SIZE_MAX);
+    ParserRelease(parser);
+
+    if (root == NULL)
+    {
+        return NULL;
+    }
+
+    JsonDoc* doc = DocCreate(root);
+
+    if (doc == NULL)
+    {
+        Destroy(root);
+        return NULL;
+    }
+
+    size_t bytes = sizeof(JsonCacheEntry) + length + valueBytes;
+
+    if (bytes > cache->maxBytes || (entry = malloc(sizeof(JsonCacheEntry) + length)) == NULL)
+    {
+        // not cached, the caller owns the only reference
+        return doc;
+    }
+
+    entry->hash   = hash;
+    entry->length = length;
+    entry->doc    = doc;
+    entry->bytes  = bytes;
+    memcpy(entry + 1, jsonString, length);
+
+    CacheLock(cache);
+
+    JsonCacheEntry* other = CacheFind(cache, hash, jsonString, length);
+
+    if (other != NULL)
+    {
+        // the same json parsed by other thread at same time
+        CacheLruRemove (cache, other);
+        CacheLruAddHead(cache, other);
+
+        JsonDoc* otherDoc = DocRetain(other->doc);
+        CacheUnlock(cache);
+
+        DocRelease(doc);
+        free(entry);
+
+        return otherDoc;
+    }
+
+    while (cache->stats->usedBytes + bytes > cache->maxBytes)
+    {
+        ++cache->stats->evictCount;
+        CacheRemove(cache, cache->lruTail);
+    }
+
+    if (cache->stats->docCount >= cache->capacity)
+    {
+        CacheGrow(cache);
+    }
+
+    JsonCacheEntry** link = cache->buckets + (hash & (uint64_t) (cache->capacity - 1));
+    entry->next           = *link;
+    *link                 = entry;
+
+    CacheLruAddHead(cache, entry);
+    ++cache->stats->docCount;
+    cache->stats->usedBytes += bytes;
+
+    // one reference for cache and one for caller
+    DocRetain(doc);
+    CacheUnlock(cache);
+
+    return doc;
+}
+
+
+static void CacheGetStats(JsonCache* cache, JsonCacheStats* outStats)
+{
+    CacheLock(cache);
+    *outStats = *cache->stats;
+    CacheUnlock(cache);
+}
+
+
+struct AJsonCache AJsonCache[1] =
+{{
+    CacheCreate,
+    CacheDestroy,
+    CacheParse,
+    CacheGetStats,
+}};
+
+
+
+// JsonColumn extraction
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The max key ordinals of record that cached for matching the columns.
+ */
+#define JsonColumn_MaxShapeKeys 64
+
+
+/**
+ * One cached key of record shape.
+ */
+typedef struct
+{
+    const char* key;
+    int         keyLength;
+
+    /**
+     * The index of columns, -1 means not a column.
+     */
+    int         columnIndex;
+}
+JsonColumnShapeKey;
+
+
+static void ColumnSetNull(JsonColumn* column, int row, bool isNull)
+{
+    if (column->nullBitmap != NULL)
+    {
+        if (isNull)
+        {
+            column->nullBitmap[row >> 3] |= (uint8_t) (1u << (row & 7));
+        }
+        else
+        {
+            column->nullBitmap[row >> 3] &= (uint8_t) ~(1u << (row & 7));
+        }
+    }
+}
+
+
+/**
+ * Set the row of all columns to default value and null.
+ */
+static void ColumnsInitRow(JsonColumn* columns, int columnCount, int row)
+{
+    for (int i = 0; i < columnCount; ++i)
+    {
+        JsonColumn* column = columns + i;
+
+        switch (column->type)
+        {
+            case JsonColumnType_Float64:
+                ((double*) column->values)[row] = 0.0;
+                break;
+
+            case JsonColumnType_Int64:
+                ((int64_t*) column->values)[row] = 0;
+                break;
+
+            case JsonColumnType_Bool:
+                ((uint8_t*) column->values)[row] = 0;
+                break;
+
+            case JsonColumnType_String:
+                ((int*) column->values)[row] = column->stringSize;
+                column->lengths[row]         = 0;
+                break;
+        }
+
+        ColumnSetNull(column, row, true);
+    }
+}
+
+
+/**
+ * Copy string into the stringData of column,
+ * if the stringCapacity is not enough the stringSize still increased and row keeps null.
+ */
+static void ColumnSetString(JsonColumn* column, int row, const char* str, int length)
+{
+    int offset          = column->stringSize;
+    column->stringSize += length;
+
+    if (column->stringSize <= column->stringCapacity)
+    {
+        memcpy(column->stringData + offset, str, (size_t) length);
+        ((int*) column->values)[row] = offset;
+        column->lengths[row]         = length;
+        ColumnSetNull(column, row, false);
+    }
+}
+
+
+/**
+ * The Int64 column only sets the integral number in int64 range, others keep null.
+ */
+static void ColumnSetNumber(JsonColumn* column, int row, const JsonExactNumber* number)
+{
+    switch (column->type)
+    {
+        case JsonColumnType_Float64:
+            ((double*) column->values)[row] =
+                number->isInt64 ? (double) number->number.int64 : number->number.float64;
+            break;
+
+        case JsonColumnType_Int64:
+            if (number->isInt64 == false)
+            {
+                return;
+            }
+
+            ((int64_t*) column->values)[row] = number->number.int64;
+            break;
+
+        default:
+            return;
+    }
+
+    ColumnSetNull(column, row, false);
+}
+
+
+static void ColumnSetBool(JsonColumn* column, int row, bool value)
+{
+    if (column->type == JsonColumnType_Bool)
+    {
+        ((uint8_t*) column->values)[row] = value;
+        ColumnSetNull(column, row, false);
+    }
+}
+
+
+/**
+ * Find the index of key in the columns, -1 means not found.
+ */
+static int ColumnsFindKey(JsonColumn* columns, int columnCount, const char* key, int keyLength)
+{
+    for (int i = 0; i < columnCount; ++i)
+    {
+        if (strncmp(columns[i].key, key, (size_t) keyLength) == 0 && columns[i].key[keyLength] == '\0')
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+static void ColumnsResetStrings(JsonColumn* columns, int columnCount)
+{
+    for (int i = 0; i < columnCount; ++i)
+    {
+        columns[i].stringSize = 0;
+    }
+}
+
+
+static int ColumnFromArray(JsonArray* array, JsonColumn* columns, int columnCount, int maxRows)
+{
+    if (columnCount <= 0)
+    {
+        // no zero length array of guesses
+        return 0;
+    }
+
+    // the guess index of each column key in the sorted map of record,
+    // records with same shape hit the guess so no BinarySearch
+    int guesses   [columnCount];
+    int keyLengths[columnCount];
+    int rows      = array->valueList->size < maxRows ? array->valueList->size : maxRows;
+
+    for (int i = 0; i < columnCount; ++i)
+    {
+        guesses   [i] = -1;
+        keyLengths[i] = (int) strlen(columns[i].key) + 1;
+    }
+
+    ColumnsResetStrings(columns, columnCount);
+
+    for (int row = 0; row < rows; ++row)
+    {
+        ColumnsInitRow(columns, columnCount, row);
+
+        if (array->packedType != JsonPacked_None)
+        {
+            continue;
+        }
+
+        JsonValue* record = &AArrayList_Get(array->valueList, row, JsonValue);
+
+        if (record->type != JsonType_Object)
+        {
+            continue;
+        }
+
+        ArrayList* elementList = record->jsonObject->valueMap->elementList;
+
+        for (int i = 0; i < columnCount; ++i)
+        {
+            JsonColumn*         column  = columns + i;
+            int                 guess   = guesses[i];
+            ArrayStrMapElement* element;
+
+            if
+            (
+                guess < 0                                                                       ||
+                guess >= elementList->size                                                      ||
+                (element = AArrayList_Get(elementList, guess, ArrayStrMapElement*))->keyLength
+                != keyLengths[i]                                                                ||
+                memcmp(element->key, column->key, (size_t) keyLengths[i]) != 0
+            )
+            {
+                // the record shape changed
+                guess = BinarySearch(elementList, column->key, keyLengths[i]);
+
+                if (guess < 0)
+                {
+                    continue;
+                }
+
+                guesses[i] = guess;
+                element    = AArrayList_Get(elementList, guess, ArrayStrMapElement*);
+            }
+
+            JsonValue* value = element->valuePtr;
+
+            switch (value->type)
+            {
+                case JsonType_Float:
+                {
+                    // the raw text of lazy number parsed exactly
+                    JsonExactNumber number;
+                    GetExactNumber (value, &number);
+                    ColumnSetNumber(column, row, &number);
+                    break;
+                }
+
+                case JsonType_String:
+                {
+                    const char* str = AJsonValue_GetString(value);
+
+                    if (strcmp(str, "null") == 0)
+                    {
+                        // the json null stored as string "null"
+                        break;
+                    }
+
+                    if (column->type == JsonColumnType_String)
+                    {
+                        ColumnSetString(column, row, str, (int) strlen(str));
+                    }
+                    else if (strcmp(str, "true") == 0)
+                    {
+                        ColumnSetBool(column, row, true);
+                    }
+                    else if (strcmp(str, "false") == 0)
+                    {
+                        ColumnSetBool(column, row, false);
+                    }
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    return rows;
+}
+
+
+/**
+ * Scan one value of json for the column, the value not matched column type keeps null.
+ */
+static void ColumnScanValue(JsonColumn* column, int row, const char** jsonPtr)
+{
+    SkipWhiteSpace(jsonPtr);
+
+    const char* json = *jsonPtr;
+
+    switch (*json)
+    {
+        case '"':
+            if (column->type == JsonColumnType_String)
+            {
+                const char* strStart;
+                int         length = SkipString(jsonPtr, &strStart);
+
+                if (length >= 0)
+                {
+                    ColumnSetString(column, row, strStart, length);
+                }
+                return;
+            }
+            break;
+
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '-':
+        {
+            JsonExactNumber number;
+            NumberParseExact(jsonPtr, &number);
+            ColumnSetNumber (column, row, &number);
+            return;
+        }
+
+        case 't':
+            ColumnSetBool(column, row, true);
+            break;
+
+        case 'f':
+            ColumnSetBool(column, row, false);
+            break;
+
+        default:
+            break;
+    }
+
+    SkipValue(jsonPtr);
+}
+
+
+static int ColumnFromJson(const char* json, JsonColumn* columns, int columnCount, int maxRows)
+{
+    // the keys of last record by ordinal,
+    // records with same shape match the key at same ordinal so no columns search
+    JsonColumnShapeKey shapeKeys[JsonColumn_MaxShapeKeys];
+    int                shapeCount = 0;
+    int                rows       = 0;
+
+    if (columnCount <= 0)
+    {
+        return 0;
+    }
+
+    ColumnsResetStrings(columns, columnCount);
+    SkipWhiteSpace(&json);
+
+    if (*json != '[')
+    {
+        ALog_D("Json ColumnFromJson error, char = %c, should be '[' ", *json);
+        return -1;
+    }
+
+    // skip '['
+    ++json;
+
+    while (rows < maxRows)
+    {
+        SkipWhiteSpace(&json);
+
+        if (*json == ']')
+        {
+            break;
+        }
+
+        int row = rows++;
+        ColumnsInitRow(columns, columnCount, row);
+
+        if (*json != '{')
+        {
+            SkipValue(&json);
+        }
+        else
+        {
+            // skip '{'
+            ++json;
+
+            for (int ordinal = 0; true; ++ordinal)
+            {
+                SkipWhiteSpace(&json);
+
+                if (*json == '}')
+                {
+                    break;
+                }
+
+                if (*json != '"')
+                {
+                    ALog_D("Json ColumnFromJson error, char = %c, should be '\"' ", *json);
+                    return -1;
+                }
+
+                const char* key;
+                int         keyLength = SkipString(&json, &key);
+                int         columnIndex;
+
+                if (keyLength < 0)
+                {
+                    ALog_D("Json ColumnFromJson error, key string is incomplete");
+                    return -1;
+                }
+
+                if
+                (
+                    ordinal < shapeCount                           &&
+                    shapeKeys[ordinal].keyLength == keyLength      &&
+                    memcmp(shapeKeys[ordinal].key, key, (size_t) keyLength) == 0
+                )
+                {
+                    columnIndex = shapeKeys[ordinal].columnIndex;
+                }
+                else
+                {
+                    // the record shape changed
+                    columnIndex = ColumnsFindKey(columns, columnCount, key, keyLength);
+
+                    if (ordinal < JsonColumn_MaxShapeKeys)
+                    {
+                        shapeKeys[ordinal].key         = key;
+                        shapeKeys[ordinal].keyLength   = keyLength;
+                        shapeKeys[ordinal].columnIndex = columnIndex;
+                        shapeCount                     = ordinal + 1;
+                    }
+                }
+
+                SkipWhiteSpace(&json);
+
+                if (*json != ':')
+                {
+                    ALog_D("Json ColumnFromJson error, char = %c, should be ':' ", *json);
+                    return -1;
+                }
+
+                // skip ':'
+                ++json;
+
+                if (columnIndex >= 0)
+                {
+                    ColumnScanValue(columns + columnIndex, row, &json);
+                }
+                else
+                {
+                    SkipValue(&json);
+                }
+
+                SkipWhiteSpace(&json);
+
+                if (*json == ',')
+                {
+                    ++json;
+                }
+                else if (*json == '}')
+                {
+                    break;
+                }
+                else
+                {
+                    // the '\0' of incomplete json stops here
+                    ALog_D("Json ColumnFromJson error, char = %c, should be '}' ", *json);
+                    return -1;
+                }
+            }
+
+            // skip '}'
+            ++json;
+        }
+
+        SkipWhiteSpace(&json);
+
+        if (*json == ',')
+        {
+            ++json;
+        }
+        else if (*json == ']')
+        {
+            break;
+        }
+        else
+        {
+            ALog_D("Json ColumnFromJson error, char = %c, should be ']' ", *json);
+            return -1;
+        }
+    }
+
+    return rows;
+}
+
+
+struct AJsonColumn AJsonColumn[1] =
+{{
+    ColumnFromArray,
+    ColumnFromJson,
+}};
+
+
+// JsonIndex sidecar offset index
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The magic and version of saved index file.
+ */
+#define JsonIndex_Magic         "MJIX"
+#define JsonIndex_Version       2
+
+/**
+ * The leading bytes of json hashed to check the index is built from it.
+ */
+#define JsonIndex_SourceBytes   4096
+
+/**
+ * The first increase of index lists, then the increase doubles with capacity.
+ */
+#define JsonIndex_MinIncrease   1024
+
+
+/**
+ * The byte range of one record in json.
+ */
+typedef struct
+{
+    uint64_t offset;
+    uint64_t length;
+}
+JsonIndexRecord;
+
+
+/**
+ * The raw value of indexed key in one record.
+ */
+typedef struct
+{
+    /**
+     * The hash of raw value, the keyList sorted by it.
+     */
+    uint64_t hash;
+
+    /**
+     * The byte range of raw value in json, the string value not contains quotes.
+     */
+    uint64_t offset;
+    uint64_t length;
+
+    /**
+     * The record index.
+     */
+    int64_t  record;
+}
+JsonIndexKey;
+
+
+/**
+ * The header of saved index file, followed by key, records and keys.
+ */
+typedef struct
+{
+    char     magic[4];
+    uint32_t version;
+    int64_t  recordCount;
+    int64_t  keyCount;
+    int64_t  keyLength;
+    uint64_t sourceLength;
+    uint64_t sourceHash;
+}
+JsonIndexHeader;
+
+
+struct JsonIndex
+{
+    /**
+     * The indexed key of object records, end with '\0', NULL means no keys.
+     */
+    char*                      key;
+
+    /**
+     * The length of json that built from, and the hash of its leading JsonIndex_SourceBytes.
+     */
+    uint64_t                   sourceLength;
+    uint64_t                   sourceHash;
+
+    ArrayList(JsonIndexRecord) recordList[1];
+
+    /**
+     * Sorted by hash of raw value.
+     */
+    ArrayList(JsonIndexKey)    keyList[1];
+};
+
+
+/**
+ * Add element into list that the increase doubles with capacity, so huge index no need realloc many times.
+ * if unable to alloc memory return false.
+ */
+static bool IndexListAdd(ArrayList* list, void* elementPtr)
+{
+    if (list->size == list->elementArr->length)
+    {
+        list->increase = list->elementArr->length > JsonIndex_MinIncrease ?
+                         list->elementArr->length : JsonIndex_MinIncrease;
+    }
+
+    return ArrayListAdd(defaultAllocator, list, elementPtr) != NULL;
+}
+
+
+static const char* IndexSkipWhiteSpace(const char* json, const char* end)
+{
+    while (json < end && (*json == ' ' || *json == '\t' || *json == '\n' || *json == '\r'))
+    {
+        ++json;
+    }
+
+    return json;
+}
+
+
+/**
+ * Skip one json value not beyond end, return the pointer after value, if value incomplete return NULL.
+ */
+static const char* IndexSkipValue(const char* json, const char* end)
+{
+    const char* start = json;
+    int         depth = 0;
+
+    while (json < end)
+    {
+        switch (*json)
+        {
+            case '"':
+                // skip string that may contains brackets
+                for (++json; json < end && *json != '"'; ++json)
+                {
+                    if (*json == '\\')
+                    {
+                        ++json;
+                    }
+                }
+
+                if (json >= end)
+                {
+                    return NULL;
+                }
+                break;
+
+            case '{':
+            case '[':
+                ++depth;
+                break;
+
+            case '}':
+            case ']':
+                if (depth == 0)
+                {
+                    // the end of container that value in
+                    return json;
+                }
+
+                --depth;
+                break;
+
+            case ',':
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+            case '\0':
+                if (depth == 0)
+                {
+                    // the end of number, true, false and null
+                    return json;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        ++json;
+
+        if (depth == 0 && (json[-1] == '"' || json[-1] == '}' || json[-1] == ']'))
+        {
+            return json;
+        }
+    }
+
+    // the number, true, false and null can end with json
+    return depth == 0 && json > start ? json : NULL;
+}
+
+
+/**
+ * Scan one record and add it into index, if the record is object, add the raw value of index key.
+ * return the pointer after record, if record incomplete or unable to alloc memory return NULL.
+ */
+static const char* IndexAddRecord(JsonIndex* index, const char* base, const char* json, const char* end)
+{
+    const char* start    = json;
+    int64_t     record   = index->recordList->size;
+    int         keyLen   = index->key != NULL ? (int) strlen(index->key) : 0;
+    bool        isObject = index->key != NULL && *json == '{';
+
+    if (isObject)
+    {
+        // skip '{'
+        json = IndexSkipWhiteSpace(json + 1, end);
+
+        while (json < end && *json == '"')
+        {
+            const char* keyStart = json + 1;
+
+            if ((json = IndexSkipValue(json, end)) == NULL)
+            {
+                return NULL;
+            }
+
+            bool isMatched = json - keyStart - 1 == keyLen && memcmp(keyStart, index->key, (size_t) keyLen) == 0;
+            json           = IndexSkipWhiteSpace(json, end);
+
+            if (json >= end || *json != ':')
+            {
+                return NULL;
+            }
+
+            const char* value = IndexSkipWhiteSpace(json + 1, end);
+
+            if ((json = IndexSkipValue(value, end)) == NULL)
+            {
+                return NULL;
+            }
+
+            if (isMatched)
+            {
+                JsonIndexKey key;
+                size_t       quote = *value == '"' ? 1 : 0;
+
+                key.offset = (uint64_t) (value - base) + quote;
+                key.length = (uint64_t) (json - value) - quote * 2;
+                key.hash   = HashBytes(JsonHash_Seed, base + key.offset, key.length);
+                key.record = record;
+
+                if (IndexListAdd(index->keyList, &key) == false)
+                {
+                    return NULL;
+                }
+            }
+
+            json = IndexSkipWhiteSpace(json, end);
+
+            if (json < end && *json == ',')
+            {
+                json = IndexSkipWhiteSpace(json + 1, end);
+            }
+        }
+
+        if (json >= end || *json != '}')
+        {
+            return NULL;
+        }
+
+        // skip '}'
+        ++json;
+    }
+    else if ((json = IndexSkipValue(json, end)) == NULL)
+    {
+        return NULL;
+    }
+
+    JsonIndexRecord indexRecord = {(uint64_t) (start - base), (uint64_t) (json - start)};
+
+    return IndexListAdd(index->recordList, &indexRecord) ? json : NULL;
+}
+
+
+static int IndexCompareKey(const void* a, const void* b)
+{
+    uint64_t hashA = ((const JsonIndexKey*) a)->hash;
+    uint64_t hashB = ((const JsonIndexKey*) b)->hash;
+
+    if (hashA != hashB)
+    {
+        return hashA < hashB ? -1 : 1;
+    }
+
+    // keep the record order of same hash
+    int64_t recordA = ((const JsonIndexKey*) a)->record;
+    int64_t recordB = ((const JsonIndexKey*) b)->record;
+
+    return recordA < recordB ? -1 : recordA > recordB;
+}
+
+
+static JsonIndex* IndexCreate(const char* key, size_t keyLength)
+{
+    JsonIndex* index = malloc(sizeof(JsonIndex));
+
+    if (index == NULL)
+    {
+        return NULL;
+    }
+
+    ArrayListInit(sizeof(JsonIndexRecord), index->recordList);
+    ArrayListInit(sizeof(JsonIndexKey),    index->keyList);
+    index->key          = NULL;
+    index->sourceLength = 0;
+    index->sourceHash   = 0;
+
+    if (key != NULL)
+    {
+        index->key = malloc(keyLength + 1);
+
+        if (index->key == NULL)
+        {
+            free(index);
+            return NULL;
+        }
+
+        memcpy(index->key, key, keyLength);
+        index->key[keyLength] = '\0';
+    }
+
+    return index;
+}
+
+
+static void IndexDestroy(JsonIndex* index)
+{
+    ArrayListRelease(defaultAllocator, index->recordList);
+    ArrayListRelease(defaultAllocator, index->keyList);
+    free(index->key);
+    free(index);
+}
+
+
+static uint64_t IndexHashSource(const char* json, size_t length)
+{
+    return HashBytes(JsonHash_Seed, json, length < JsonIndex_SourceBytes ? length : JsonIndex_SourceBytes);
+}
+
+
+static JsonIndex* IndexBuild(const char* json, size_t length, const char* key)
+{
+    JsonIndex* index = IndexCreate(key, key != NULL ? strlen(key) : 0);
+
+    if (index == NULL)
+    {
+        return NULL;
+    }
+
+    const char* end     = json + length;
+    const char* ptr     = IndexSkipWhiteSpace(json, end);
+    bool        isArray = ptr < end && *ptr == '[';
+
+    index->sourceLength = (uint64_t) length;
+    index->sourceHash   = IndexHashSource(json, length);
+
+    if (isArray)
+    {
+        // skip '['
+        ptr = IndexSkipWhiteSpace(ptr + 1, end);
+    }
+
+    // the NDJSON records separated by white space, the array records separated by ','
+    while (ptr < end && *ptr != '\0' && (isArray == false || *ptr != ']'))
+    {
+        if ((ptr = IndexAddRecord(index, json, ptr, end)) == NULL)
+        {
+            IndexDestroy(index);
+            return NULL;
+        }
+
+        ptr = IndexSkipWhiteSpace(ptr, end);
+
+        if (isArray && ptr < end && *ptr == ',')
+        {
+            ptr = IndexSkipWhiteSpace(ptr + 1, end);
+        }
+    }
+
+    if (index->keyList->size > 1)
+    {
+        qsort(index->keyList->elementArr->data, (size_t) index->keyList->size, sizeof(JsonIndexKey), IndexCompareKey);
+    }
+
+    return index;
+}
+
+
+/**
+ * Write all elements of list, if unable to write return false.
+ */
+static bool IndexSaveList(FILE* file, ArrayList* list)
+{
+    return list->size == 0 ||
+           fwrite(list->elementArr->data, (size_t) list->elementTypeSize, (size_t) list->size, file)
+           == (size_t) list->size;
+}
+
+
+static bool IndexSave(JsonIndex* index, const char* filePath)
+{
+    FILE* file = fopen(filePath, "wb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    JsonIndexHeader header;
+    memcpy(header.magic, JsonIndex_Magic, sizeof(header.magic));
+    header.version      = JsonIndex_Version;
+    header.recordCount  = index->recordList->size;
+    header.keyCount     = index->keyList->size;
+    header.keyLength    = index->key != NULL ? (int64_t) strlen(index->key) : -1;
+    header.sourceLength = index->sourceLength;
+    header.sourceHash   = index->sourceHash;
+
+    bool isSaved =
+        fwrite(&header, sizeof(JsonIndexHeader), 1, file) == 1                                          &&
+        (
+            index->key == NULL                                                                          ||
+            fwrite(index->key, 1, (size_t) (header.keyLength + 1), file) == (size_t) (header.keyLength + 1)
+        )                                                                                               &&
+        IndexSaveList(file, index->recordList)                                                          &&
+        IndexSaveList(file, index->keyList);
+
+    return fclose(file) == 0 && isSaved;
+}
+
+
+/**
+ * Read count elements into list, if unable to alloc memory or read return false.
+ */
+static bool IndexLoadList(FILE* file, ArrayList* list, int64_t count)
+{
+    if (count < 0 || count > INT32_MAX)
+    {
+        return false;
+    }
+
+    if (count > 0 && ArrayListAddCapacity(defaultAllocator, list, (int) count) == false)
+    {
+        return false;
+    }
+
+    list->size = (int) count;
+
+    return count == 0 ||
+           fread(list->elementArr->data, (size_t) list->elementTypeSize, (size_t) count, file) == (size_t) count;
+}
+
+
+static JsonIndex* IndexLoad(const char* filePath)
+{
+    FILE* file = fopen(filePath, "rb");
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    JsonIndexHeader header;
+    JsonIndex*      index = NULL;
+
+    if
+    (
+        fread(&header, sizeof(JsonIndexHeader), 1, file) == 1                &&
+        memcmp(header.magic, JsonIndex_Magic, sizeof(header.magic)) == 0 &&
+        header.version   == JsonIndex_Version                                &&
+        header.keyLength >= -1                                               &&
+        header.keyLength <  INT32_MAX
+    )
+    {
+        index = IndexCreate(NULL, 0);
+
+        if (index != NULL && header.keyLength >= 0)
+        {
+            index->key = malloc((size_t) header.keyLength + 1);
+        }
+
+        if
+        (
+            index != NULL &&
+            (
+                header.keyLength < 0 ||
+                (
+                    index->key != NULL &&
+                    fread(index->key, 1, (size_t) header.keyLength + 1, file) == (size_t) header.keyLength + 1
+                )
+            )                                                                                    &&
+            IndexLoadList(file, index->recordList, header.recordCount)                           &&
+            IndexLoadList(file, index->keyList,    header.keyCount)
+        )
+        {
+            if (index->key != NULL)
+            {
+                // the saved key ends with '\0', but the file may be broken
+                index->key[header.keyLength] = '\0';
+            }
+
+            index->sourceLength = header.sourceLength;
+            index->sourceHash   = header.sourceHash;
+        }
+        else if (index != NULL)
+        {
+            IndexDestroy(index);
+            index = NULL;
+        }
+    }
+
+    fclose(file);
+
+    return index;
+}
+
+
+static bool IndexIsSource(JsonIndex* index, const char* json, size_t length)
+{
+    return index->sourceLength == (uint64_t) length && index->sourceHash == IndexHashSource(json, length);
+}
+
+
+static int IndexGetCount(JsonIndex* index)
+{
+    return index->recordList->size;
+}
+
+
+static bool IndexGetRecord(JsonIndex* index, int record, size_t* outOffset, size_t* outLength)
+{
+    if (record < 0 || record >= index->recordList->size)
+    {
+        return false;
+    }
+
+    JsonIndexRecord* indexRecord = &AArrayList_Get(index->recordList, record, JsonIndexRecord);
+    *outOffset                   = (size_t) indexRecord->offset;
+    *outLength                   = (size_t) indexRecord->length;
+
+    return true;
+}
+
+
+static int IndexFindKey(JsonIndex* index, const char* json, size_t jsonLength, const char* value, int length)
+{
+    uint64_t      hash = HashBytes(JsonHash_Seed, value, (size_t) length);
+    JsonIndexKey* keys = index->keyList->elementArr->data;
+    int           low  = 0;
+    int           high = index->keyList->size;
+
+    // find the first key of hash
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+
+        if (keys[mid].hash < hash)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    for (; low < index->keyList->size && keys[low].hash == hash; ++low)
+    {
+        if
+        (
+            keys[low].length == (uint64_t) length              &&
+            keys[low].length <= jsonLength                     &&
+            keys[low].offset <= jsonLength - keys[low].length  &&
+            memcmp(json + keys[low].offset, value, (size_t) length) == 0
+        )
+        {
+            return (int) keys[low].record;
+        }
+    }
+
+    return -1;
+}
+
+
+static JsonValue* IndexParseRecord(JsonIndex* index, const char* json, size_t jsonLength, int record)
+{
+    size_t offset;
+    size_t length;
+
+    if
+    (
+        IndexGetRecord(index, record, &offset, &length) == false ||
+        length     == 0                                          ||
+        jsonLength <  length                                     ||
+        offset     >  jsonLength - length
+    )
+    {
+        return NULL;
+    }
+
+    json += offset;
+
+    // the object, array and string end with their own char, so the complete record parse not beyond it,
+    // but the json may not be the one index built from
+    if (*json == '{' || *json == '[' || *json == '"')
+    {
+        return IndexSkipValue(json, json + length) == json + length ? Parse(json) : NULL;
+    }
+
+    // the number, true, false and null may end with json, so copy them with '\0'
+    char* str = malloc(length + 1);
+
+    if (str == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(str, json, length);
+    str[length] = '\0';
+
+    JsonValue* value = Parse(str);
+    free(str);
+
+    return value;
+}
+
+
+struct AJsonIndex AJsonIndex[1] =
+{{
+    IndexBuild,
+    IndexSave,
+    IndexLoad,
+    IndexDestroy,
+    IndexIsSource,
+    IndexGetCount,
+    IndexGetRecord,
+    IndexFindKey,
+    IndexParseRecord,
+}};
+
+
+// JsonFormat streaming formatter
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The size of output buffer, the JsonFormat memory is constant.
+ */
+#define JsonFormat_BufferSize   65536
+
+
+struct JsonFormat
+{
+    /**
+     * 0 minifies json, or the count of spaces for each level.
+     */
+    int    indent;
+    void   (*OnWrite)(void* context, const char* data, size_t length);
+    void*  context;
+
+    /**
+     * The level of unclosed brackets.
+     */
+    int    depth;
+
+    /**
+     * Inside string, and the next char is escaped.
+     */
+    bool   isString;
+    bool   isEscape;
+
+    /**
+     * The last bracket opened, the line break delayed until the bracket is not empty.
+     */
+    bool   isOpen;
+
+    /**
+     * Inside the number or literal token.
+     */
+    bool   isToken;
+
+    /**
+     * The top-level value ended, the next top-level value separated by line break.
+     */
+    bool   isRootEnd;
+    bool   isError;
+
+    size_t used;
+    char   buffer[JsonFormat_BufferSize];
+};
+
+
+static void FormatFlush(JsonFormat* format)
+{
+    if (format->used > 0)
+    {
+        format->OnWrite(format->context, format->buffer, format->used);
+        format->used = 0;
+    }
+}
+
+
+static void FormatOutput(JsonFormat* format, const char* data, size_t length)
+{
+    if (length > JsonFormat_BufferSize - format->used)
+    {
+        FormatFlush(format);
+
+        if (length >= JsonFormat_BufferSize)
+        {
+            format->OnWrite(format->context, data, length);
+            return;
+        }
+    }
+
+    memcpy(format->buffer + format->used, data, length);
+    format->used += length;
+}
+
+
+static inline void FormatOutputChar(JsonFormat* format, char c)
+{
+    if (format->used == JsonFormat_BufferSize)
+    {
+        FormatFlush(format);
+    }
+
+    format->buffer[format->used++] = c;
+}
+
+
+/**
+ * Output line break and the indent spaces of depth.
+ */
+static void FormatNewLine(JsonFormat* format)
+{
+    static const char spaces[] = "                                                                ";
+    size_t            count    = (size_t) format->indent * (size_t) format->depth;
+
+    FormatOutputChar(format, '\n');
+
+    while (count > 0)
+    {
+        size_t length = count < sizeof(spaces) - 1 ? count : sizeof(spaces) - 1;
+        FormatOutput(format, spaces, length);
+        count -= length;
+    }
+}
+
+
+/**
+ * Before the first char of value or key, output the delayed line break.
+ */
+static inline void FormatBeginValue(JsonFormat* format)
+{
+    if (format->isOpen)
+    {
+        format->isOpen = false;
+        FormatNewLine(format);
+    }
+    else if (format->isRootEnd)
+    {
+        format->isRootEnd = false;
+
+        if (format->depth == 0)
+        {
+            FormatOutputChar(format, '\n');
+        }
+    }
+}
+
+
+/**
+ * Return the pointer of first '"' or '\\' not beyond end.
+ */
+static const char* FormatScanString(const char* json, const char* end)
+{
+#ifdef __SSE2__
+    const __m128i quote     = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    while (end - json >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*) json);
+        int     mask  = _mm_movemask_epi8
+                        (
+                            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash))
+                        );
+
+        if (mask != 0)
+        {
+            return json + __builtin_ctz((unsigned int) mask);
+        }
+
+        json += 16;
+    }
+#endif
+
+    while (json < end && *json != '"' && *json != '\\')
+    {
+        ++json;
+    }
+
+    return json;
+}
+
+
+/**
+ * Return the pointer of first char not white space not beyond end.
+ */
+static const char* FormatSkipWhiteSpace(const char* json, const char* end)
+{
+#ifdef __SSE2__
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab   = _mm_set1_epi8('\t');
+    const __m128i lf    = _mm_set1_epi8('\n');
+    const __m128i cr    = _mm_set1_epi8('\r');
+
+    while (end - json >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*) json);
+        __m128i white = _mm_or_si128
+                        (
+                            _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                            _mm_or_si128(_mm_cmpeq_epi8(chunk, lf),    _mm_cmpeq_epi8(chunk, cr))
+                        );
+        int     mask  = _mm_movemask_epi8(white) ^ 0xFFFF;
+
+        if (mask != 0)
+        {
+            return json + __builtin_ctz((unsigned int) mask);
+        }
+
+        json += 16;
+    }
+#endif
+
+    return IndexSkipWhiteSpace(json, end);
+}
+
+
+static inline bool FormatIsTokenChar(char c)
+{
+    switch (c)
+    {
+        case ' ' :
+        case '\t':
+        case '\n':
+        case '\r':
+        case '"' :
+        case '{' :
+        case '}' :
+        case '[' :
+        case ']' :
+        case ',' :
+        case ':' :
+            return false;
+        default:
+            return true;
+    }
+}
+
+
+/**
+ * Return the pointer of first char not in number or literal token not beyond end.
+ */
+static const char* FormatScanToken(const char* json, const char* end)
+{
+#ifdef __SSE2__
+    // the token chars are all greater than ' ' and not the structural chars
+    const __m128i control = _mm_set1_epi8(' ');
+    const __m128i quote   = _mm_set1_epi8('"');
+    const __m128i comma   = _mm_set1_epi8(',');
+    const __m128i colon   = _mm_set1_epi8(':');
+    // '[' ']' and '{' '}' differ only by bit 0x20, and '[' ']' differ by 2
+    const __m128i lower   = _mm_set1_epi8(~0x20);
+    const __m128i bracket = _mm_set1_epi8('[');
+    const __m128i close   = _mm_set1_epi8(']');
+
+    while (end - json >= 16)
+    {
+        __m128i chunk  = _mm_loadu_si128((const __m128i*) json);
+        __m128i folded = _mm_and_si128(chunk, lower);
+        __m128i stop   = _mm_or_si128
+                         (
+                             _mm_or_si128
+                             (
+                                 // the unsigned c <= ' ' by min, not includes bytes of UTF-8
+                                 _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk),
+                                 _mm_cmpeq_epi8(chunk, quote)
+                             ),
+                             _mm_or_si128
+                             (
+                                 _mm_or_si128(_mm_cmpeq_epi8(chunk,  comma),   _mm_cmpeq_epi8(chunk,  colon)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(folded, bracket), _mm_cmpeq_epi8(folded, close))
+                             )
+                         );
+        int     mask   = _mm_movemask_epi8(stop);
+
+        if (mask != 0)
+        {
+            // control chars other than white space are token chars, check them by scalar
+            json += __builtin_ctz((unsigned int) mask);
+            break;
+        }
+
+        json += 16;
+    }
+#endif
+
+    while (json < end && FormatIsTokenChar(*json))
+    {
+        ++json;
+    }
+
+    return json;
+}
+
+
+static JsonFormat* FormatCreate
+(
+    int     indent,
+    void  (*OnWrite)(void* context, const char* data, size_t length),
+    void*   context
+)
+{
+    ALog_A(indent >= 0 && OnWrite != NULL, "AJsonFormat Create failed, indent < 0 or OnWrite is NULL");
+
+    JsonFormat* format = malloc(sizeof(JsonFormat));
+
+    if (format != NULL)
+    {
+        format->indent    = indent;
+        format->OnWrite   = OnWrite;
+        format->context   = context;
+        format->depth     = 0;
+        format->isString  = false;
+        format->isEscape  = false;
+        format->isOpen    = false;
+        format->isToken   = false;
+        format->isRootEnd = false;
+        format->isError   = false;
+        format->used      = 0;
+    }
+
+    return format;
+}
+
+
+static bool FormatWrite(JsonFormat* format, const char* json, size_t length)
+{
+    const char* end = json + length;
+
+    if (format->isError)
+    {
+        return false;
+    }
+
+    while (json < end)
+    {
+        if (format->isString)
+        {
+            if (format->isEscape)
+            {
+                // the escaped char may be '"'
+                format->isEscape = false;
+                FormatOutputChar(format, *json++);
+                continue;
+            }
+
+            const char* start = json;
+            json              = FormatScanString(json, end);
+            FormatOutput(format, start, (size_t) (json - start));
+
+            if (json == end)
+            {
+                break;
+            }
+
+            if (*json == '"')
+            {
+                format->isString  = false;
+                format->isRootEnd = format->depth == 0;
+            }
+            else
+            {
+                format->isEscape  = true;
+            }
+
+            FormatOutputChar(format, *json++);
+            continue;
+        }
+
+        switch (*json)
+        {
+            case ' ' :
+            case '\t':
+            case '\n':
+            case '\r':
+                if (format->isToken)
+                {
+                    format->isToken   = false;
+                    format->isRootEnd = format->depth == 0;
+                }
+
+                json = FormatSkipWhiteSpace(json, end);
+                continue;
+
+            case '"':
+                format->isToken  = false;
+                FormatBeginValue(format);
+                format->isString = true;
+                break;
+
+            case '{':
+            case '[':
+                format->isToken = false;
+                FormatBeginValue(format);
+                ++format->depth;
+                FormatOutputChar(format, *json++);
+                // line break delayed for empty brackets
+                format->isOpen  = format->indent > 0;
+                continue;
+
+            case '}':
+            case ']':
+                format->isToken = false;
+
+                if (format->depth == 0)
+                {
+                    format->isError = true;
+                    return false;
+                }
+
+                --format->depth;
+
+                if (format->isOpen)
+                {
+                    format->isOpen = false;
+                }
+                else if (format->indent > 0)
+                {
+                    FormatNewLine(format);
+                }
+
+                format->isRootEnd = format->depth == 0;
+                break;
+
+            case ',':
+                format->isToken = false;
+                FormatOutputChar(format, ',');
+
+                if (format->indent > 0)
+                {
+                    FormatNewLine(format);
+                }
+
+                ++json;
+                continue;
+
+            case ':':
+                format->isToken = false;
+                FormatOutputChar(format, ':');
+
+                if (format->indent > 0)
+                {
+                    FormatOutputChar(format, ' ');
+                }
+
+                ++json;
+                continue;
+
+            default:
+            {
+                // number or literal, may be continued from last chunk
+                if (format->isToken == false)
+                {
+                    FormatBeginValue(format);
+                    format->isToken = true;
+                }
+
+                const char* start = json;
+                json              = FormatScanToken(json, end);
+                FormatOutput(format, start, (size_t) (json - start));
+                continue;
+            }
+        }
+
+        FormatOutputChar(format, *json++);
+    }
+
+    return true;
+}
+
+
+static bool FormatFinish(JsonFormat* format)
+{
+    bool isComplete = format->isError == false && format->isString == false && format->depth == 0;
+
+    FormatFlush(format);
+
+    format->depth     = 0;
+    format->isString  = false;
+    format->isEscape  = false;
+    format->isOpen    = false;
+    format->isToken   = false;
+    format->isRootEnd = false;
+    format->isError   = false;
+
+    return isComplete;
+}
+
+
+static void FormatDestroy(JsonFormat* format)
+{
+    free(format);
+}
+
+
+struct AJsonFormat AJsonFormat[1] =
+{{
+    FormatCreate,
+    FormatWrite,
+    FormatFinish,
+    FormatDestroy,
+}};
+
+
+// JsonPack MessagePack and CBOR
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The max nesting depth of containers and tags, the deeper data is invalid.
+ */
+#define JsonPack_MaxDepth       512
+
+/**
+ * The reserved header size of MessagePack container, backpatched to the smallest size when closed.
+ */
+#define JsonPack_ContainerHead  5
+
+/**
+ * The number text not longer than it is converted in stack buffer.
+ */
+#define JsonPack_NumberLength   64
+
+
+typedef struct
+{
+    JsonPackFormat packFormat;
+    char*          buffer;
+    size_t         capacity;
+
+    /**
+     * The length of output, the bytes beyond capacity are only counted.
+     */
+    size_t         length;
+
+    /**
+     * The max length of output, greater than capacity when any bytes dropped.
+     */
+    size_t         peak;
+
+    /**
+     * The depth of containers.
+     */
+    int            depth;
+}
+JsonPackWriter;
+
+
+typedef struct
+{
+    JsonPackFormat packFormat;
+    const uint8_t* data;
+    const uint8_t* end;
+}
+JsonPackReader;
+
+
+static void PackSkip(JsonPackWriter* writer, size_t length)
+{
+    writer->length += length;
+
+    if (writer->length > writer->peak)
+    {
+        writer->peak = writer->length;
+    }
+}
+
+
+static void PackWrite(JsonPackWriter* writer, const void* data, size_t length)
+{
+    if (length <= writer->capacity && writer->length <= writer->capacity - length)
+    {
+        memcpy(writer->buffer + writer->length, data, length);
+    }
+
+    PackSkip(writer, length);
+}
+
+
+static inline void PackWriteByte(JsonPackWriter* writer, uint8_t byte)
+{
+    PackWrite(writer, &byte, 1);
+}
+
+
+static inline void PackWriteText(JsonPackWriter* writer, const char* text)
+{
+    PackWrite(writer, text, strlen(text));
+}
+
+
+/**
+ * Write the byte followed by big-endian value of size bytes.
+ */
+static void PackWriteHead(JsonPackWriter* writer, uint8_t byte, uint64_t value, int size)
+{
+    uint8_t data[9];
+    data[0] = byte;
+
+    for (int i = 0; i < size; ++i)
+    {
+        data[1 + i] = (uint8_t) (value >> (8 * (size - 1 - i)));
+    }
+
+    PackWrite(writer, data, (size_t) size + 1);
+}
+
+
+/**
+ * Write the CBOR major type with the argument of smallest size.
+ */
+static void PackWriteCborHead(JsonPackWriter* writer, int major, uint64_t value)
+{
+    uint8_t type = (uint8_t) (major << 5);
+
+    if (value < 24)
+    {
+        PackWriteByte(writer, (uint8_t) (type | value));
+    }
+    else if (value <= UINT8_MAX)
+    {
+        PackWriteHead(writer, type | 24, value, 1);
+    }
+    else if (value <= UINT16_MAX)
+    {
+        PackWriteHead(writer, type | 25, value, 2);
+    }
+    else if (value <= UINT32_MAX)
+    {
+        PackWriteHead(writer, type | 26, value, 4);
+    }
+    else
+    {
+        PackWriteHead(writer, type | 27, value, 8);
+    }
+}
+
+
+static void PackWriteUint(JsonPackWriter* writer, uint64_t value)
+{
+    if (writer->packFormat == JsonPackFormat_CBOR)
+    {
+        PackWriteCborHead(writer, 0, value);
+    }
+    else if (value <= 0x7F)
+    {
+        PackWriteByte(writer, (uint8_t) value);
+    }
+    else if (value <= UINT8_MAX)
+    {
+        PackWriteHead(writer, 0xCC, value, 1);
+    }
+    else if (value <= UINT16_MAX)
+    {
+        PackWriteHead(writer, 0xCD, value, 2);
+    }
+    else if (value <= UINT32_MAX)
+    {
+        PackWriteHead(writer, 0xCE, value, 4);
+    }
+    else
+    {
+        PackWriteHead(writer, 0xCF, value, 8);
+    }
+}
+
+
+/**
+ * Write the negative integer of magnitude that in [1, 2^63].
+ */
+static void PackWriteNegative(JsonPackWriter* writer, uint64_t magnitude)
+{
+    if (writer->packFormat == JsonPackFormat_CBOR)
+    {
+        PackWriteCborHead(writer, 1, magnitude - 1);
+        return;
+    }
+
+    int64_t value = -(int64_t) (magnitude - 1) - 1;
+
+    if (value >= -32)
+    {
+        PackWriteByte(writer, (uint8_t) value);
+    }
+    else if (value >= INT8_MIN)
+    {
+        PackWriteHead(writer, 0xD0, (uint64_t) value, 1);
+    }
+    else if (value >= INT16_MIN)
+    {
+        PackWriteHead(writer, 0xD1, (uint64_t) value, 2);
+    }
+    else if (value >= INT32_MIN)
+    {
+        PackWriteHead(writer, 0xD2, (uint64_t) value, 4);
+    }
+    else
+    {
+        PackWriteHead(writer, 0xD3, (uint64_t) value, 8);
+    }
+}
+
+
+static void PackWriteDouble(JsonPackWriter* writer, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    PackWriteHead(writer, writer->packFormat == JsonPackFormat_CBOR ? 0xFB : 0xCB, bits, 8);
+}
+
+
+/**
+ * If the length of MessagePack string greater than 32 bits return false.
+ */
+static bool PackWriteStringHead(JsonPackWriter* writer, size_t length)
+{
+    if (writer->packFormat == JsonPackFormat_CBOR)
+    {
+        PackWriteCborHead(writer, 3, length);
+    }
+    else if (length < 32)
+    {
+        PackWriteByte(writer, (uint8_t) (0xA0 | length));
+    }
+    else if (length <= UINT8_MAX)
+    {
+        PackWriteHead(writer, 0xD9, length, 1);
+    }
+    else if (length <= UINT16_MAX)
+    {
+        PackWriteHead(writer, 0xDA, length, 2);
+    }
+    else if (length <= UINT32_MAX)
+    {
+        PackWriteHead(writer, 0xDB, length, 4);
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Return the offset of container header for PackCloseContainer.
+ */
+static size_t PackOpenContainer(JsonPackWriter* writer, bool isMap)
+{
+    size_t offset = writer->length;
+
+    if (writer->packFormat == JsonPackFormat_CBOR)
+    {
+        // indefinite length
+        PackWriteByte(writer, isMap ? 0xBF : 0x9F);
+    }
+    else
+    {
+        // the count is unknown until closed
+        PackSkip(writer, JsonPack_ContainerHead);
+    }
+
+    return offset;
+}
+
+
+/**
+ * Write the MessagePack header of count and move the body after it, or the CBOR break.
+ * if the count greater than 32 bits return false.
+ */
+static bool PackCloseContainer(JsonPackWriter* writer, size_t offset, bool isMap, uint64_t count)
+{
+    if (writer->packFormat == JsonPackFormat_CBOR)
+    {
+        PackWriteByte(writer, 0xFF);
+        return true;
+    }
+
+    uint8_t head[JsonPack_ContainerHead];
+    int     size;
+
+    if (count < 16)
+    {
+        head[0] = (uint8_t) ((isMap ? 0x80 : 0x90) | count);
+        size    = 1;
+    }
+    else if (count <= UINT16_MAX)
+    {
+        head[0] = isMap ? 0xDE : 0xDC;
+        head[1] = (uint8_t) (count >> 8);
+        head[2] = (uint8_t) count;
+        size    = 3;
+    }
+    else if (count <= UINT32_MAX)
+    {
+        head[0] = isMap ? 0xDF : 0xDD;
+        head[1] = (uint8_t) (count >> 24);
+        head[2] = (uint8_t) (count >> 16);
+        head[3] = (uint8_t) (count >> 8);
+        head[4] = (uint8_t) count;
+        size    = 5;
+    }
+    else
+    {
+        return false;
+    }
+
+    // if any bytes dropped, the output is only counted
+    if (writer->peak <= writer->capacity)
+    {
+        char* body = writer->buffer + offset + JsonPack_ContainerHead;
+
+        memmove(body - (JsonPack_ContainerHead - size), body, writer->length - offset - JsonPack_ContainerHead);
+        memcpy (writer->buffer + offset, head, (size_t) size);
+    }
+
+    writer->length -= (size_t) (JsonPack_ContainerHead - size);
+
+    return true;
+}
+
+
+// JsonPack from json
+//----------------------------------------------------------------------------------------------------------------------
+
+
+static bool PackReadHex4(const char* str, const char* end, uint32_t* outCode)
+{
+    if (end - str < 4)
+    {
+        return false;
+    }
+
+    uint32_t code = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        char c = str[i];
+
+        if (c >= '0' && c <= '9')
+        {
+            code = code << 4 | (uint32_t) (c - '0');
+        }
+        else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+        {
+            code = code << 4 | (uint32_t) ((c | 0x20) - 'a' + 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    *outCode = code;
+
+    return true;
+}
+
+
+/**
+ * Encode the code point into UTF-8, return the bytes count.
+ */
+static int PackEncodeUtf8(uint32_t code, uint8_t* outUtf8)
+{
+    if (code < 0x80)
+    {
+        outUtf8[0] = (uint8_t) code;
+        return 1;
+    }
+
+    if (code < 0x800)
+    {
+        outUtf8[0] = (uint8_t) (0xC0 | code >> 6);
+        outUtf8[1] = (uint8_t) (0x80 | (code & 0x3F));
+        return 2;
+    }
+
+    if (code < 0x10000)
+    {
+        outUtf8[0] = (uint8_t) (0xE0 | code >> 12);
+        outUtf8[1] = (uint8_t) (0x80 | (code >> 6 & 0x3F));
+        outUtf8[2] = (uint8_t) (0x80 | (code & 0x3F));
+        return 3;
+    }
+
+    outUtf8[0] = (uint8_t) (0xF0 | code >> 18);
+    outUtf8[1] = (uint8_t) (0x80 | (code >> 12 & 0x3F));
+    outUtf8[2] = (uint8_t) (0x80 | (code >> 6  & 0x3F));
+    outUtf8[3] = (uint8_t) (0x80 | (code & 0x3F));
+    return 4;
+}
+
+
+/**
+ * Decode the escaped chars of string into writer, if writer is NULL only count.
+ * the lone surrogate decoded as U+FFFD.
+ *
+ * return the length of decoded string, if the escape is invalid return SIZE_MAX.
+ */
+static size_t PackUnescape(const char* str, const char* end, JsonPackWriter* writer)
+{
+    size_t length = 0;
+
+    while (true)
+    {
+        const char* start = str;
+
+        while (str < end && *str != '\\')
+        {
+            ++str;
+        }
+
+        length += (size_t) (str - start);
+
+        if (writer != NULL)
+        {
+            PackWrite(writer, start, (size_t) (str - start));
+        }
+
+        if (str == end)
+        {
+            return length;
+        }
+
+        // the escaped char is before end, that checked by PackJsonString
+        char    c    = str[1];
+        uint8_t utf8[4];
+        int     size = 1;
+
+        str += 2;
+
+        switch (c)
+        {
+            case '"' :
+            case '\\':
+            case '/' :
+                utf8[0] = (uint8_t) c;
+                break;
+
+            case 'b':
+                utf8[0] = '\b';
+                break;
+
+            case 'f':
+                utf8[0] = '\f';
+                break;
+
+            case 'n':
+                utf8[0] = '\n';
+                break;
+
+            case 'r':
+                utf8[0] = '\r';
+                break;
+
+            case 't':
+                utf8[0] = '\t';
+                break;
+
+            case 'u':
+            {
+                uint32_t code;
+                uint32_t low;
+
+                if (PackReadHex4(str, end, &code) == false)
+                {
+                    return SIZE_MAX;
+                }
+
+                str += 4;
+
+                if
+                (
+                    code >= 0xD800 && code <= 0xDBFF            &&
+                    end - str >= 6 && str[0] == '\\' && str[1] == 'u' &&
+                    PackReadHex4(str + 2, end, &low)            &&
+                    low >= 0xDC00  && low <= 0xDFFF
+                )
+                {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    str += 6;
+                }
+                else if (code >= 0xD800 && code <= 0xDFFF)
+                {
+                    code = 0xFFFD;
+                }
+
+                size = PackEncodeUtf8(code, utf8);
+                break;
+            }
+
+            default:
+                return SIZE_MAX;
+        }
+
+        length += (size_t) size;
+
+        if (writer != NULL)
+        {
+            PackWrite(writer, utf8, (size_t) size);
+        }
+    }
+}
+
+
+/**
+ * The *jsonPtr is at '"', and moves after the string.
+ */
+static bool PackJsonString(JsonPackWriter* writer, const char** jsonPtr, const char* end)
+{
+    const char* start    = *jsonPtr + 1;
+    const char* json     = start;
+    bool        isEscape = false;
+
+    while (true)
+    {
+        json = FormatScanString(json, end);
+
+        if (json >= end)
+        {
+            return false;
+        }
+
+        if (*json == '"')
+        {
+            break;
+        }
+
+        // skip the escaped char that may be '"'
+        isEscape  = true;
+        json     += 2;
+    }
+
+    size_t length = isEscape ? PackUnescape(start, json, NULL) : (size_t) (json - start);
+
+    if (length == SIZE_MAX || PackWriteStringHead(writer, length) == false)
+    {
+        return false;
+    }
+
+    if (isEscape)
+    {
+        PackUnescape(start, json, writer);
+    }
+    else
+    {
+        PackWrite(writer, start, length);
+    }
+
+    *jsonPtr = json + 1;
+
+    return true;
+}
+
+
+static inline bool PackIsDigit(const char* json, const char* end)
+{
+    return json < end && *json >= '0' && *json <= '9';
+}
+
+
+/**
+ * The integer packed as int if in range of int64 or uint64, otherwise as float64.
+ */
+static bool PackJsonNumber(JsonPackWriter* writer, const char** jsonPtr, const char* end)
+{
+    const char* start      = *jsonPtr;
+    const char* json       = start;
+    bool        isNegative = *json == '-';
+    bool        isInteger  = true;
+    bool        isOverflow = false;
+    uint64_t    value      = 0;
+
+    if (isNegative)
+    {
+        ++json;
+    }
+
+    if (PackIsDigit(json, end) == false)
+    {
+        return false;
+    }
+
+    if (*json == '0')
+    {
+        ++json;
+    }
+    else
+    {
+        do
+        {
+            uint64_t digit = (uint64_t) (*json++ - '0');
+
+            if (value > (UINT64_MAX - digit) / 10)
+            {
+                isOverflow = true;
+            }
+
+            value = value * 10 + digit;
+        }
+        while (PackIsDigit(json, end));
+    }
+
+    if (json < end && *json == '.')
+    {
+        isInteger = false;
+
+        if (PackIsDigit(++json, end) == false)
+        {
+            return false;
+        }
+
+        while (PackIsDigit(++json, end));
+    }
+
+    if (json < end && (*json == 'e' || *json == 'E'))
+    {
+        isInteger = false;
+        ++json;
+
+        if (json < end && (*json == '+' || *json == '-'))
+        {
+            ++json;
+        }
+
+        if (PackIsDigit(json, end) == false)
+        {
+            return false;
+        }
+
+        while (PackIsDigit(++json, end));
+    }
+
+    *jsonPtr = json;
+
+    if (isInteger && isOverflow == false)
+    {
+        if (isNegative == false || value == 0)
+        {
+            PackWriteUint(writer, value);
+            return true;
+        }
+
+        if (value <= (uint64_t) INT64_MAX + 1)
+        {
+            PackWriteNegative(writer, value);
+            return true;
+        }
+    }
+
+    // the json not end with '\0', so copy number text for strtod
+    size_t length = (size_t) (json - start);
+    char   stackText[JsonPack_NumberLength];
+    char*  text   = length < JsonPack_NumberLength ? stackText : malloc(length + 1);
+
+    if (text == NULL)
+    {
+        return false;
+    }
+
+    memcpy(text, start, length);
+    text[length] = '\0';
+
+    PackWriteDouble(writer, strtod(text, NULL));
+
+    if (text != stackText)
+    {
+        free(text);
+    }
+
+    return true;
+}
+
+
+static bool PackJsonValue(JsonPackWriter* writer, const char** jsonPtr, const char* end);
+
+
+/**
+ * The *jsonPtr is at '[' or '{', and moves after the container.
+ */
+static bool PackJsonContainer(JsonPackWriter* writer, const char** jsonPtr, const char* end, bool isMap)
+{
+    if (++writer->depth > JsonPack_MaxDepth)
+    {
+        return false;
+    }
+
+    const char* json   = IndexSkipWhiteSpace(*jsonPtr + 1, end);
+    size_t      offset = PackOpenContainer(writer, isMap);
+    uint64_t    count  = 0;
+    char        close  = isMap ? '}' : ']';
+
+    if (json < end && *json == close)
+    {
+        ++json;
+    }
+    else
+    {
+        while (true)
+        {
+            if (isMap)
+            {
+                if (json == end || *json != '"' || PackJsonString(writer, &json, end) == false)
+                {
+                    return false;
+                }
+
+                json = IndexSkipWhiteSpace(json, end);
+
+                if (json == end || *json != ':')
+                {
+                    return false;
+                }
+
+                ++json;
+            }
+
+            if (PackJsonValue(writer, &json, end) == false)
+            {
+                return false;
+            }
+
+            ++count;
+            json = IndexSkipWhiteSpace(json, end);
+
+            if (json == end)
+            {
+                return false;
+            }
+
+            if (*json == ',')
+            {
+                json = IndexSkipWhiteSpace(json + 1, end);
+                continue;
+            }
+
+            if (*json == close)
+            {
+                ++json;
+                break;
+            }
+
+            return false;
+        }
+    }
+
+    --writer->depth;
+    *jsonPtr = json;
+
+    return PackCloseContainer(writer, offset, isMap, count);
+}
+
+
+static bool PackJsonLiteral(const char** jsonPtr, const char* end, const char* literal, size_t length)
+{
+    if ((size_t) (end - *jsonPtr) < length || memcmp(*jsonPtr, literal, length) != 0)
+    {
+        return false;
+    }
+
+    *jsonPtr += length;
+
+    return true;
+}
+
+
+static bool PackJsonValue(JsonPackWriter* writer, const char** jsonPtr, const char* end)
+{
+    const char* json   = IndexSkipWhiteSpace(*jsonPtr, end);
+    bool        isCbor = writer->packFormat == JsonPackFormat_CBOR;
+
+    *jsonPtr = json;
+
+    if (json == end)
+    {
+        return false;
+    }
+
+    switch (*json)
+    {
+        case '{':
+            return PackJsonContainer(writer, jsonPtr, end, true);
+
+        case '[':
+            return PackJsonContainer(writer, jsonPtr, end, false);
+
+        case '"':
+            return PackJsonString(writer, jsonPtr, end);
+
+        case 't':
+            PackWriteByte(writer, isCbor ? 0xF5 : 0xC3);
+            return PackJsonLiteral(jsonPtr, end, "true", 4);
+
+        case 'f':
+            PackWriteByte(writer, isCbor ? 0xF4 : 0xC2);
+            return PackJsonLiteral(jsonPtr, end, "false", 5);
+
+        case 'n':
+            PackWriteByte(writer, isCbor ? 0xF6 : 0xC0);
+            return PackJsonLiteral(jsonPtr, end, "null", 4);
+
+        default:
+            return PackJsonNumber(writer, jsonPtr, end);
+    }
+}
+
+
+static size_t PackFromJson(JsonPackFormat packFormat, const char* json, size_t length, char* buffer, size_t capacity)
+{
+    JsonPackWriter writer[1] = {{packFormat, buffer, capacity, 0, 0, 0}};
+    const char*    end       = json + length;
+
+    if (PackJsonValue(writer, &json, end) == false || IndexSkipWhiteSpace(json, end) != end)
+    {
+        return 0;
+    }
+
+    return writer->peak > capacity ? writer->peak : writer->length;
+}
+
+
+// JsonPack to json
+//----------------------------------------------------------------------------------------------------------------------
+
+
+static bool PackReadUint(JsonPackReader* reader, int size, uint64_t* outValue)
+{
+    if (reader->end - reader->data < size)
+    {
+        return false;
+    }
+
+    uint64_t value = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        value = value << 8 | reader->data[i];
+    }
+
+    reader->data += size;
+    *outValue     = value;
+
+    return true;
+}
+
+
+static void PackWriteJsonUint(JsonPackWriter* writer, uint64_t value)
+{
+    char text[24];
+    PackWrite(writer, text, (size_t) snprintf(text, sizeof(text), "%llu", (unsigned long long) value));
+}
+
+
+static void PackWriteJsonInt(JsonPackWriter* writer, int64_t value)
+{
+    char text[24];
+    PackWrite(writer, text, (size_t) snprintf(text, sizeof(text), "%lld", (long long) value));
+}
+
+
+/**
+ * Write the shortest text that converts back to same value, the NaN and infinity written as null.
+ */
+static void PackWriteJsonDouble(JsonPackWriter* writer, double value, bool isFloat)
+{
+    // only the finite value minus itself is zero
+    if (value - value != 0.0)
+    {
+        PackWriteText(writer, "null");
+        return;
+    }
+
+    char text[32];
+    int  length       = 0;
+    int  precision    = isFloat ? 6 : 15;
+    int  maxPrecision = isFloat ? 9 : 17;
+
+    for (; precision <= maxPrecision; ++precision)
+    {
+        length = snprintf(text, sizeof(text), "%.*g", precision, value);
+
+        if (isFloat ? strtof(text, NULL) == (float) value : strtod(text, NULL) == value)
+        {
+            break;
+        }
+    }
+
+    PackWrite(writer, text, (size_t) length);
+}
+
+
+/**
+ * Write the chars of string with json escape, not contains quotes.
+ */
+static void PackWriteJsonChars(JsonPackWriter* writer, const uint8_t* str, size_t length)
+{
+    const uint8_t* end = str + length;
+
+    while (str < end)
+    {
+        const uint8_t* start = str;
+
+        while (str < end && *str >= 0x20 && *str != '"' && *str != '\\')
+        {
+            ++str;
+        }
+
+        PackWrite(writer, start, (size_t) (str - start));
+
+        if (str == end)
+        {
+            break;
+        }
+
+        char escape[8];
+        int  size = 2;
+
+        escape[0] = '\\';
+
+        switch (*str)
+        {
+            case '"' :
+            case '\\':
+                escape[1] = (char) *str;
+                break;
+
+            case '\b':
+                escape[1] = 'b';
+                break;
+
+            case '\f':
+                escape[1] = 'f';
+                break;
+
+            case '\n':
+                escape[1] = 'n';
+                break;
+
+            case '\r':
+                escape[1] = 'r';
+                break;
+
+            case '\t':
+                escape[1] = 't';
+                break;
+
+            default:
+                size = snprintf(escape, sizeof(escape), "\\u%04x", *str);
+                break;
+        }
+
+        PackWrite(writer, escape, (size_t) size);
+        ++str;
+    }
+}
+
+
+static bool PackReadJsonString(JsonPackReader* reader, JsonPackWriter* writer, uint64_t length, bool isQuoted)
+{
+    if ((uint64_t) (reader->end - reader->data) < length)
+    {
+        return false;
+    }
+
+    if (isQuoted)
+    {
+        PackWriteByte(writer, '"');
+    }
+
+    PackWriteJsonChars(writer, reader->data, (size_t) length);
+    reader->data += length;
+
+    if (isQuoted)
+    {
+        PackWriteByte(writer, '"');
+    }
+
+    return true;
+}
+
+
+static bool PackReadJsonValue(JsonPackReader* reader, JsonPackWriter* writer);
+
+
+/**
+ * Whether the next value of reader is string, for the key of map.
+ */
+static bool PackIsString(JsonPackReader* reader)
+{
+    if (reader->data == reader->end)
+    {
+        return false;
+    }
+
+    uint8_t byte = *reader->data;
+
+    if (reader->packFormat == JsonPackFormat_CBOR)
+    {
+        return byte >> 5 == 3;
+    }
+
+    return (byte >= 0xA0 && byte <= 0xBF) || (byte >= 0xD9 && byte <= 0xDB);
+}
+
+
+/**
+ * If count is UINT64_MAX, the CBOR container is indefinite length that ends with break.
+ */
+static bool PackReadJsonContainer(JsonPackReader* reader, JsonPackWriter* writer, bool isMap, uint64_t count)
+{
+    PackWriteByte(writer, isMap ? '{' : '[');
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        if (count == UINT64_MAX && reader->data < reader->end && *reader->data == 0xFF)
+        {
+            ++reader->data;
+            break;
+        }
+
+        if (i > 0)
+        {
+            PackWriteByte(writer, ',');
+        }
+
+        if (isMap)
+        {
+            if (PackIsString(reader) == false || PackReadJsonValue(reader, writer) == false)
+            {
+                return false;
+            }
+
+            PackWriteByte(writer, ':');
+        }
+
+        if (PackReadJsonValue(reader, writer) == false)
+        {
+            return false;
+        }
+    }
+
+    PackWriteByte(writer, isMap ? '}' : ']');
+
+    return true;
+}
+
+
+static bool PackReadMessagePack(JsonPackReader* reader, JsonPackWriter* writer)
+{
+    uint8_t  byte = *reader->data++;
+    uint64_t value;
+
+    if (byte <= 0x7F)
+    {
+        PackWriteJsonUint(writer, byte);
+        return true;
+    }
+
+    if (byte >= 0xE0)
+    {
+        PackWriteJsonInt(writer, (int64_t) byte - 0x100);
+        return true;
+    }
+
+    if (byte <= 0x8F)
+    {
+        return PackReadJsonContainer(reader, writer, true,  byte & 0x0F);
+    }
+
+    if (byte <= 0x9F)
+    {
+        return PackReadJsonContainer(reader, writer, false, byte & 0x0F);
+    }
+
+    if (byte <= 0xBF)
+    {
+        return PackReadJsonString(reader, writer, byte & 0x1F, true);
+    }
+
+    switch (byte)
+    {
+        case 0xC0:
+            PackWriteText(writer, "null");
+            return true;
+
+        case 0xC2:
+            PackWriteText(writer, "false");
+            return true;
+
+        case 0xC3:
+            PackWriteText(writer, "true");
+            return true;
+
+        case 0xCA:
+        {
+            if (PackReadUint(reader, 4, &value) == false)
+            {
+                return false;
+            }
+
+            uint32_t bits = (uint32_t) value;
+            float    f;
+            memcpy(&f, &bits, sizeof(f));
+            PackWriteJsonDouble(writer, f, true);
+
+            return true;
+        }
+
+        case 0xCB:
+        {
+            if (PackReadUint(reader, 8, &value) == false)
+            {
+                return false;
+            }
+
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            PackWriteJsonDouble(writer, d, false);
+
+            return true;
+        }
+
+        case 0xCC:
+        case 0xCD:
+        case 0xCE:
+        case 0xCF:
+            if (PackReadUint(reader, 1 << (byte - 0xCC), &value) == false)
+            {
+                return false;
+            }
+
+            PackWriteJsonUint(writer, value);
+            return true;
+
+        case 0xD0:
+        case 0xD1:
+        case 0xD2:
+        case 0xD3:
+        {
+            int bits = 8 << (byte - 0xD0);
+
+            if (PackReadUint(reader, bits / 8, &value) == false)
+            {
+                return false;
+            }
+
+            // sign extend by the complement of magnitude
+            uint64_t mask = bits == 64 ? UINT64_MAX : (1ULL << bits) - 1;
+
+            if (value >> (bits - 1) & 1)
+            {
+                PackWriteJsonInt(writer, -(int64_t) (~value & mask) - 1);
+            }
+            else
+            {
+                PackWriteJsonInt(writer, (int64_t) value);
+            }
+
+            return true;
+        }
+
+        case 0xD9:
+        case 0xDA:
+        case 0xDB:
+            return PackReadUint(reader, 1 << (byte - 0xD9), &value) &&
+                   PackReadJsonString(reader, writer, value, true);
+
+        case 0xDC:
+        case 0xDD:
+            return PackReadUint(reader, byte == 0xDC ? 2 : 4, &value) &&
+                   PackReadJsonContainer(reader, writer, false, value);
+
+        case 0xDE:
+        case 0xDF:
+            return PackReadUint(reader, byte == 0xDE ? 2 : 4, &value) &&
+                   PackReadJsonContainer(reader, writer, true, value);
+
+        default:
+            // the binary and extension types
+            return false;
+    }
+}
+
+
+/**
+ * Convert the CBOR half-precision float, the NaN and infinity written as null.
+ */
+static void PackWriteJsonHalf(JsonPackWriter* writer, uint16_t half)
+{
+    int    exponent = half >> 10 & 0x1F;
+    int    mantissa = half & 0x3FF;
+    double value;
+
+    if (exponent == 0x1F)
+    {
+        PackWriteText(writer, "null");
+        return;
+    }
+
+    if (exponent == 0)
+    {
+        value = mantissa / 16777216.0;
+    }
+    else if (exponent >= 25)
+    {
+        value = (double) (mantissa + 1024) * (double) (1 << (exponent - 25));
+    }
+    else
+    {
+        value = (double) (mantissa + 1024) / (double) (1 << (25 - exponent));
+    }
+
+    PackWriteJsonDouble(writer, half >> 15 ? -value : value, true);
+}
+
+
+static bool PackReadCbor(JsonPackReader* reader, JsonPackWriter* writer)
+{
+    uint8_t  byte  = *reader->data++;
+    int      major = byte >> 5;
+    int      info  = byte & 0x1F;
+    uint64_t value = (uint64_t) info;
+
+    if (info == 31)
+    {
+        switch (major)
+        {
+            case 3:
+                // the chunks of definite text string until break
+                PackWriteByte(writer, '"');
+
+                while (true)
+                {
+                    if (reader->data == reader->end)
+                    {
+                        return false;
+                    }
+
+                    byte = *reader->data++;
+
+                    if (byte == 0xFF)
+                    {
+                        break;
+                    }
+
+                    info = byte & 0x1F;
+
+                    if
+                    (
+                        byte >> 5 != 3 || info > 27 ||
+                        (info >= 24 && PackReadUint(reader, 1 << (info - 24), &value) == false) ||
+                        PackReadJsonString(reader, writer, info >= 24 ? value : (uint64_t) info, false) == false
+                    )
+                    {
+                        return false;
+                    }
+                }
+
+                PackWriteByte(writer, '"');
+                return true;
+
+            case 4:
+                return PackReadJsonContainer(reader, writer, false, UINT64_MAX);
+
+            case 5:
+                return PackReadJsonContainer(reader, writer, true,  UINT64_MAX);
+
+            default:
+                // the indefinite byte string, or the break not in container
+                return false;
+        }
+    }
+
+    if (info > 27 || (info >= 24 && PackReadUint(reader, 1 << (info - 24), &value) == false))
+    {
+        return false;
+    }
+
+    switch (major)
+    {
+        case 0:
+            PackWriteJsonUint(writer, value);
+            return true;
+
+        case 1:
+            if (value <= INT64_MAX)
+            {
+                PackWriteJsonInt(writer, -(int64_t) value - 1);
+            }
+            else
+            {
+                PackWriteJsonDouble(writer, -1.0 - (double) value, false);
+            }
 
-static int ArrayGetInt(JsonArray* array, int index)
+            return true;
+
+        case 3:
+            return PackReadJsonString(reader, writer, value, true);
+
+        case 4:
+            if (value == UINT64_MAX)
+            {
+                return false;
+            }
+
+            return PackReadJsonContainer(reader, writer, false, value);
+
+        case 5:
+            if (value == UINT64_MAX)
+            {
+                return false;
+            }
+
+            return PackReadJsonContainer(reader, writer, true, value);
+
+        case 6:
+            // ignore the tag of value
+            return PackReadJsonValue(reader, writer);
+
+        case 7:
+            switch (info)
+            {
+                case 20:
+                    PackWriteText(writer, "false");
+                    return true;
+
+                case 21:
+                    PackWriteText(writer, "true");
+                    return true;
+
+                case 22:
+                case 23:
+                    // null and undefined
+                    PackWriteText(writer, "null");
+                    return true;
+
+                case 25:
+                    PackWriteJsonHalf(writer, (uint16_t) value);
+                    return true;
+
+                case 26:
+                {
+                    uint32_t bits = (uint32_t) value;
+                    float    f;
+                    memcpy(&f, &bits, sizeof(f));
+                    PackWriteJsonDouble(writer, f, true);
+
+                    return true;
+                }
+
+                case 27:
+                {
+                    double d;
+                    memcpy(&d, &value, sizeof(d));
+                    PackWriteJsonDouble(writer, d, false);
+
+                    return true;
+                }
+
+                default:
+                    return false;
+            }
+
+        default:
+            // the byte string
+            return false;
+    }
+}
+
+
+static bool PackReadJsonValue(JsonPackReader* reader, JsonPackWriter* writer)
 {
-    return (int) AArrayList_Get(array->valueList, index, JsonValue*)->jsonFloat;
+    if (reader->data == reader->end || ++writer->depth > JsonPack_MaxDepth)
+    {
+        return false;
+    }
+
+    bool isValid = reader->packFormat == JsonPackFormat_CBOR ?
+                   PackReadCbor       (reader, writer) :
+                   PackReadMessagePack(reader, writer);
+
+    --writer->depth;
+
+    return isValid;
 }
 
-static float ArrayGetFloat(JsonArray* array, int index)
+
+static size_t PackToJson(JsonPackFormat packFormat, const char* data, size_t length, char* buffer, size_t capacity)
+{
+    JsonPackReader reader[1] = {{packFormat, (const uint8_t*) data, (const uint8_t*) data + length}};
+    JsonPackWriter writer[1] = {{packFormat, buffer, capacity, 0, 0, 0}};
+
+    if (PackReadJsonValue(reader, writer) == false || reader->data != reader->end)
+    {
+        return 0;
+    }
+
+    if (writer->length < capacity)
+    {
+        buffer[writer->length] = '\0';
+    }
+
+    return writer->length;
+}
+
+
+struct AJsonPack AJsonPack[1] =
+{{
+    PackFromJson,
+    PackToJson,
+}};
+
+
+
+// JsonFilter predicate pushdown
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The max count of comparisons, "&&" and "||" in one expression, and also the max count of path keys.
+ */
+#define JsonFilter_MaxNodes     64
+
+/**
+ * The max length of number text that compared with number literal.
+ */
+#define JsonFilter_NumberLength 64
+
+
+typedef enum
 {
-    return AArrayList_Get(array->valueList, index, JsonValue*)->jsonFloat;
+    JsonFilterNode_Compare,
+    JsonFilterNode_And,
+    JsonFilterNode_Or,
 }
+JsonFilterNodeType;
 
 
-static char* ArrayGetString(JsonArray* array, int index)
+typedef enum
 {
-    return AArrayList_Get(array->valueList, index, JsonValue*)->jsonString;
+    JsonFilterOp_Equal,
+    JsonFilterOp_NotEqual,
+    JsonFilterOp_Less,
+    JsonFilterOp_LessEqual,
+    JsonFilterOp_Greater,
+    JsonFilterOp_GreaterEqual,
 }
+JsonFilterOp;
 
 
-static JsonObject* ArrayGetObject(JsonArray* array, int index)
+typedef enum
 {
-    return AArrayList_Get(array->valueList, index, JsonValue*)->jsonObject;
+    JsonFilterLiteral_String,
+    JsonFilterLiteral_Number,
+
+    /**
+     * The true, false and null that compared by raw text.
+     */
+    JsonFilterLiteral_Keyword,
 }
+JsonFilterLiteral;
 
 
-static JsonArray* ArrayGetArray(JsonArray* array, int index)
+/**
+ * The result of comparison or node when scan, the Unknown is the field not scanned yet.
+ */
+typedef enum
 {
-    return AArrayList_Get(array->valueList, index, JsonValue*)->jsonArray;
+    JsonFilterState_Unknown,
+    JsonFilterState_False,
+    JsonFilterState_True,
 }
+JsonFilterState;
 
 
-static JsonType ArrayGetType(JsonArray* array, int index)
+typedef struct
 {
-    if (index < 0 || index >= array->valueList->size)
+    JsonFilterNodeType type;
+
+    /**
+     * The children nodes of And and Or.
+     */
+    int                left;
+    int                right;
+
+    /**
+     * The comparison of field and literal, the string literal is raw text in expression without quotes.
+     */
+    JsonFilterOp       op;
+    JsonFilterLiteral  literalType;
+    const char*        literal;
+    int                literalLength;
+    double             number;
+
+    /**
+     * The next comparison of same path, -1 is end.
+     */
+    int                nextCompare;
+}
+JsonFilterNode;
+
+
+/**
+ * The key of path tree, the root path has no key and matches the record object.
+ */
+typedef struct
+{
+    const char* key;
+    int         keyLength;
+    int         firstChild;
+    int         nextSibling;
+
+    /**
+     * The first comparison of the value of this path, -1 is none.
+     */
+    int         firstCompare;
+}
+JsonFilterPath;
+
+
+struct JsonFilter
+{
+    /**
+     * The copy of expression that keys and literals point into.
+     */
+    char*          expression;
+
+    /**
+     * The root node of expression.
+     */
+    int            root;
+
+    int            nodeCount;
+    JsonFilterNode nodes[JsonFilter_MaxNodes];
+
+    int            pathCount;
+    JsonFilterPath paths[JsonFilter_MaxNodes];
+};
+
+
+/**
+ * The state of compiling expression.
+ */
+typedef struct
+{
+    JsonFilter* filter;
+    const char* ptr;
+
+    /**
+     * The nesting of parentheses.
+     */
+    int         depth;
+}
+JsonFilterCompiler;
+
+
+static inline const char* FilterSkipSpace(const char* ptr)
+{
+    while (*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r')
     {
-        return JsonType_Null;
+        ++ptr;
     }
-    
-    return AArrayList_Get(array->valueList, index, JsonValue*)->type;
+
+    return ptr;
 }
 
 
-struct AJsonArray AJsonArray[1] =
-{{
-    ArrayGetBool,
-    ArrayGetInt,
-    ArrayGetFloat,
-    ArrayGetType,
-    ArrayGetString,
-    ArrayGetObject,
-    ArrayGetArray,
-}};
+/**
+ * Whether the char can be in the key without quotes.
+ */
+static inline bool FilterIsKeyChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == '$' || c == '@';
+}
+
+
+/**
+ * Skip the quoted string of expression, return the pointer after quote, if not closed return NULL.
+ */
+static const char* FilterSkipQuoted(const char* ptr)
+{
+    for (++ptr; *ptr != '"'; ++ptr)
+    {
+        if (*ptr == '\0' || (*ptr == '\\' && *++ptr == '\0'))
+        {
+            return NULL;
+        }
+    }
+
+    return ptr + 1;
+}
+
+
+/**
+ * Get the child path of key or add it, if nodes full return -1.
+ */
+static int FilterAddPath(JsonFilter* filter, int parent, const char* key, int keyLength)
+{
+    int child = filter->paths[parent].firstChild;
+
+    for (; child != -1; child = filter->paths[child].nextSibling)
+    {
+        JsonFilterPath* path = filter->paths + child;
+
+        if (path->keyLength == keyLength && memcmp(path->key, key, (size_t) keyLength) == 0)
+        {
+            return child;
+        }
+    }
+
+    if (filter->pathCount == JsonFilter_MaxNodes)
+    {
+        return -1;
+    }
+
+    JsonFilterPath* path = filter->paths + filter->pathCount;
+    path->key            = key;
+    path->keyLength      = keyLength;
+    path->firstChild     = -1;
+    path->nextSibling    = filter->paths[parent].firstChild;
+    path->firstCompare   = -1;
+
+    filter->paths[parent].firstChild = filter->pathCount;
+
+    return filter->pathCount++;
+}
+
+
+/**
+ * Add node of type, if nodes full return -1.
+ */
+static int FilterAddNode(JsonFilter* filter, JsonFilterNodeType type, int left, int right)
+{
+    if (filter->nodeCount == JsonFilter_MaxNodes)
+    {
+        return -1;
+    }
+
+    JsonFilterNode* node = filter->nodes + filter->nodeCount;
+    node->type           = type;
+    node->left           = left;
+    node->right          = right;
+    node->nextCompare    = -1;
+
+    return filter->nodeCount++;
+}
+
+
+/**
+ * Compile "path op literal", return the node index, if invalid return -1.
+ */
+static int FilterCompileCompare(JsonFilterCompiler* compiler)
+{
+    JsonFilter* filter = compiler->filter;
+    const char* ptr    = FilterSkipSpace(compiler->ptr);
+    int         path   = 0;
+
+    do
+    {
+        const char* key = ptr;
+        int         keyLength;
+
+        if (*ptr == '"')
+        {
+            if ((ptr = FilterSkipQuoted(ptr)) == NULL)
+            {
+                return -1;
+            }
+
+            // the key without quotes
+            ++key;
+            keyLength = (int) (ptr - key) - 1;
+        }
+        else
+        {
+            while (FilterIsKeyChar(*ptr))
+            {
+                ++ptr;
+            }
+
+            keyLength = (int) (ptr - key);
+
+            if (keyLength == 0)
+            {
+                return -1;
+            }
+        }
+
+        path = FilterAddPath(filter, path, key, keyLength);
+
+        if (path == -1)
+        {
+            return -1;
+        }
+
+        if (*ptr != '.')
+        {
+            break;
+        }
+
+        // skip '.'
+        ++ptr;
+    }
+    while (true);
+
+    JsonFilterOp op;
+    ptr = FilterSkipSpace(ptr);
+
+    switch (ptr[0])
+    {
+        case '=':
+            if (ptr[1] != '=')
+            {
+                return -1;
+            }
+            op   = JsonFilterOp_Equal;
+            ptr += 2;
+            break;
+
+        case '!':
+            if (ptr[1] != '=')
+            {
+                return -1;
+            }
+            op   = JsonFilterOp_NotEqual;
+            ptr += 2;
+            break;
+
+        case '<':
+            op   = ptr[1] == '=' ? JsonFilterOp_LessEqual : JsonFilterOp_Less;
+            ptr += ptr[1] == '=' ? 2 : 1;
+            break;
+
+        case '>':
+            op   = ptr[1] == '=' ? JsonFilterOp_GreaterEqual : JsonFilterOp_Greater;
+            ptr += ptr[1] == '=' ? 2 : 1;
+            break;
+
+        default:
+            return -1;
+    }
+
+    int nodeIndex = FilterAddNode(filter, JsonFilterNode_Compare, -1, -1);
+
+    if (nodeIndex == -1)
+    {
+        return -1;
+    }
+
+    JsonFilterNode* node = filter->nodes + nodeIndex;
+    node->op             = op;
+    ptr                  = FilterSkipSpace(ptr);
+    node->literal        = ptr;
+
+    if (*ptr == '"')
+    {
+        if ((ptr = FilterSkipQuoted(ptr)) == NULL)
+        {
+            return -1;
+        }
+
+        node->literalType   = JsonFilterLiteral_String;
+        node->literal      += 1;
+        node->literalLength = (int) (ptr - node->literal) - 1;
+    }
+    else if
+    (
+        (strncmp(ptr, "true",  4) == 0 && FilterIsKeyChar(ptr[4]) == false) ||
+        (strncmp(ptr, "null",  4) == 0 && FilterIsKeyChar(ptr[4]) == false) ||
+        (strncmp(ptr, "false", 5) == 0 && FilterIsKeyChar(ptr[5]) == false)
+    )
+    {
+        node->literalType   = JsonFilterLiteral_Keyword;
+        node->literalLength = *ptr == 'f' ? 5 : 4;
+        ptr                += node->literalLength;
+    }
+    else
+    {
+        char* endPtr;
+        node->literalType   = JsonFilterLiteral_Number;
+        node->number        = strtod(ptr, &endPtr);
+        node->literalLength = (int) (endPtr - ptr);
+
+        if (endPtr == ptr)
+        {
+            return -1;
+        }
+
+        ptr = endPtr;
+    }
+
+    // the comparisons of same path scanned together
+    node->nextCompare                = filter->paths[path].firstCompare;
+    filter->paths[path].firstCompare = nodeIndex;
+    compiler->ptr                    = ptr;
+
+    return nodeIndex;
+}
+
+
+static int FilterCompileOr(JsonFilterCompiler* compiler);
+
+
+/**
+ * Compile comparison or the expression in parentheses, if invalid return -1.
+ */
+static int FilterCompileTerm(JsonFilterCompiler* compiler)
+{
+    compiler->ptr = FilterSkipSpace(compiler->ptr);
+
+    if (*compiler->ptr != '(')
+    {
+        return FilterCompileCompare(compiler);
+    }
+
+    // the depth not more than nodes, so the deep parentheses cannot overflow the stack
+    if (++compiler->depth > JsonFilter_MaxNodes)
+    {
+        return -1;
+    }
+
+    // skip '('
+    ++compiler->ptr;
+
+    int nodeIndex = FilterCompileOr(compiler);
+    compiler->ptr = FilterSkipSpace(compiler->ptr);
 
+    if (nodeIndex == -1 || *compiler->ptr != ')')
+    {
+        return -1;
+    }
 
-// Json parser
-//----------------------------------------------------------------------------------------------------------------------
+    // skip ')'
+    ++compiler->ptr;
+    --compiler->depth;
 
+    return nodeIndex;
+}
 
-static void SkipWhiteSpace(const char** jsonPtr)
+
+/**
+ * Compile the terms joined by "&&", if invalid return -1.
+ */
+static int FilterCompileAnd(JsonFilterCompiler* compiler)
 {
-    const char* json = *jsonPtr;
+    int left = FilterCompileTerm(compiler);
 
-    while (true)
+    while (left != -1)
     {
-        switch (*json)
+        compiler->ptr = FilterSkipSpace(compiler->ptr);
+
+        if (compiler->ptr[0] != '&' || compiler->ptr[1] != '&')
         {
-            case ' ' :
-            case '\t':
-            case '\n':
-            case '\r':
-                ++json;
-                continue;
-            default:
-                break;
+            break;
         }
-        break;
+
+        compiler->ptr += 2;
+        int right      = FilterCompileTerm(compiler);
+        left           = right == -1 ? -1 : FilterAddNode(compiler->filter, JsonFilterNode_And, left, right);
     }
 
-    ALog_A(json != NULL, "The Json parse error on NULL, json is incomplete.");
-    
-    *jsonPtr = json;
+    return left;
 }
 
 
-static void* ParseNumber(const char** jsonPtr)
+/**
+ * Compile the terms joined by "||", the "&&" binds tighter, if invalid return -1.
+ */
+static int FilterCompileOr(JsonFilterCompiler* compiler)
 {
-    char* endPtr;
+    int left = FilterCompileAnd(compiler);
 
-    JsonValue* value = CreateJsonValue(NULL, 0, JsonType_Float);
-    value->jsonFloat = strtof(*jsonPtr, &endPtr);
+    while (left != -1)
+    {
+        compiler->ptr = FilterSkipSpace(compiler->ptr);
 
-    ALog_D("Json number = %.*s", (int) (endPtr - *jsonPtr), *jsonPtr);
-    
-    *jsonPtr = endPtr;
+        if (compiler->ptr[0] != '|' || compiler->ptr[1] != '|')
+        {
+            break;
+        }
 
-    return value;
+        compiler->ptr += 2;
+        int right      = FilterCompileAnd(compiler);
+        left           = right == -1 ? -1 : FilterAddNode(compiler->filter, JsonFilterNode_Or, left, right);
+    }
+
+    return left;
 }
 
 
-static int SkipString(const char** jsonPtr, const char** outStrStart)
+static JsonFilter* FilterCreate(const char* expression)
 {
-    // skip '"'
-    const char* json  = ++(*jsonPtr);
-    int         count = 0;
-    char        c;
+    size_t      length = strlen(expression);
+    JsonFilter* filter = malloc(sizeof(JsonFilter) + length + 1);
 
-    // check end '"'
-    while ((c = json[count++]) != '"')
+    if (filter == NULL)
     {
-        if (c == '\\')
-        {
-            // skip escaped quotes
-            // the escape char may be '\"'，which will break while
-            ++count;
-        }
+        return NULL;
     }
 
-    *outStrStart = json;
-    
-    // already skipped the string end '"'
-    *jsonPtr    += count;
+    filter->expression = (char*) (filter + 1);
+    memcpy(filter->expression, expression, length + 1);
 
-    // how many char skipped
-    // count contains the string end '"', so -1
-    return count - 1;
-}
+    filter->nodeCount  = 0;
+    filter->pathCount  = 1;
+    filter->paths->key = NULL;
 
+    filter->paths->keyLength    = 0;
+    filter->paths->firstChild   = -1;
+    filter->paths->nextSibling  = -1;
+    filter->paths->firstCompare = -1;
 
-static JsonValue* ParseString(const char** jsonPtr)
-{
-    const char* strStart;
-    int         length        = SkipString(jsonPtr, &strStart);
-    JsonValue*  value         = CreateJsonValue((void*) strStart, (length + 1) * sizeof(char), JsonType_String);
-    value->jsonString[length] = '\0';
+    JsonFilterCompiler compiler[1] = {{filter, filter->expression, 0}};
+    filter->root                   = FilterCompileOr(compiler);
 
-    ALog_D("Json string = %s", value->jsonString);
+    if (filter->root == -1 || *FilterSkipSpace(compiler->ptr) != '\0')
+    {
+        free(filter);
+        return NULL;
+    }
 
-    return value;
+    return filter;
 }
 
 
-// predefine
-static JsonValue* ParseValue(const char** jsonPtr);
+static void FilterDestroy(JsonFilter* filter)
+{
+    free(filter);
+}
 
 
-static JsonValue* ParseArray(const char** jsonPtr)
+/**
+ * Compare the raw value not beyond valueEnd with literal of node.
+ */
+static bool FilterCompare(const JsonFilterNode* node, const char* value, const char* valueEnd)
 {
-    JsonValue* jsonValue = CreateJsonValue(NULL, sizeof(JsonArray), JsonType_Array);
-    ArrayList* list      = jsonValue->jsonArray->valueList;
-
-    ALog_D("Json Array: [");
-    
-    // skip '['
-    ++(*jsonPtr);
+    size_t length       = (size_t) (valueEnd - value);
+    bool   isComparable = false;
+    int    order        = 0;
 
-    do
+    switch (node->literalType)
     {
-        SkipWhiteSpace(jsonPtr);
+        case JsonFilterLiteral_String:
+            if (*value == '"' && length >= 2)
+            {
+                size_t rawLength = length - 2;
+                size_t litLength = (size_t) node->literalLength;
 
-        if (**jsonPtr == ']')
-        {
+                order        = memcmp(value + 1, node->literal, rawLength < litLength ? rawLength : litLength);
+                order        = order != 0 ? order : (rawLength > litLength) - (rawLength < litLength);
+                isComparable = true;
+            }
             break;
-        }
 
-        JsonValue* value = ParseValue(jsonPtr);
-        // add Array element
-        AArrayList_Add(list, value);
-         
-        SkipWhiteSpace(jsonPtr);
+        case JsonFilterLiteral_Number:
+            if (((*value >= '0' && *value <= '9') || *value == '-') && length < JsonFilter_NumberLength)
+            {
+                // the json not end with '\0', so copy number text for strtod
+                char text[JsonFilter_NumberLength];
+                memcpy(text, value, length);
+                text[length] = '\0';
+
+                double number = strtod(text, NULL);
+                order         = (number > node->number) - (number < node->number);
+                isComparable  = true;
+            }
+            break;
 
-        if (**jsonPtr == ',')
-        {
-            ++(*jsonPtr);
-        }
-        else
-        {
-            ALog_A(**jsonPtr == ']', "Json Array not has ']', error char = %c ", **jsonPtr);
+        case JsonFilterLiteral_Keyword:
+            // the true, false and null only equal to same text
+            isComparable = length == (size_t) node->literalLength && memcmp(value, node->literal, length) == 0;
             break;
-        }
     }
-    while (true);
 
-    // skip ']'
-    ++(*jsonPtr);
-    ALog_D("] JsonArray element count = %d", list->size);
-    
-    return jsonValue;
+    if (isComparable == false)
+    {
+        return node->op == JsonFilterOp_NotEqual;
+    }
+
+    switch (node->op)
+    {
+        case JsonFilterOp_Equal:
+            return order == 0;
+
+        case JsonFilterOp_NotEqual:
+            return order != 0;
+
+        case JsonFilterOp_Less:
+            return order < 0;
+
+        case JsonFilterOp_LessEqual:
+            return order <= 0;
+
+        case JsonFilterOp_Greater:
+            return order > 0;
+
+        case JsonFilterOp_GreaterEqual:
+            return order >= 0;
+    }
+
+    return false;
 }
 
 
-static JsonValue* ParseObject(const char** jsonPtr)
+/**
+ * Evaluate node by the states of comparisons, if isFinal the Unknown comparison is False (missing field).
+ */
+static JsonFilterState FilterEvaluate(JsonFilter* filter, int nodeIndex, const int8_t* states, bool isFinal)
 {
-    JsonValue*   jsonValue = CreateJsonValue(NULL, sizeof(JsonObject), JsonType_Object);
-    ArrayStrMap* map       = jsonValue->jsonObject->valueMap;
+    JsonFilterNode* node = filter->nodes + nodeIndex;
 
-    ALog_D("Json Object: {");
-    
+    if (node->type == JsonFilterNode_Compare)
+    {
+        return states[nodeIndex] == JsonFilterState_Unknown && isFinal ?
+               JsonFilterState_False : (JsonFilterState) states[nodeIndex];
+    }
+
+    // the False decides "&&" and the True decides "||"
+    JsonFilterState decided = node->type == JsonFilterNode_And ? JsonFilterState_False : JsonFilterState_True;
+    JsonFilterState left    = FilterEvaluate(filter, node->left, states, isFinal);
+
+    if (left == decided)
+    {
+        return decided;
+    }
+
+    JsonFilterState right = FilterEvaluate(filter, node->right, states, isFinal);
+
+    if (right == decided)
+    {
+        return decided;
+    }
+
+    return left == JsonFilterState_Unknown || right == JsonFilterState_Unknown ? JsonFilterState_Unknown : left;
+}
+
+
+/**
+ * Scan the object of path, and compare the raw values of child paths.
+ * return the pointer after object, if the result decided or the object incomplete return NULL.
+ */
+static const char* FilterScanObject(JsonFilter* filter, int pathIndex, const char* json, const char* end, int8_t* states)
+{
     // skip '{'
-    ++(*jsonPtr);
+    json = IndexSkipWhiteSpace(json + 1, end);
 
-    do
+    while (json < end && *json == '"')
     {
-        SkipWhiteSpace(jsonPtr);
+        const char* key = json + 1;
 
-        if (**jsonPtr == '}')
+        if ((json = IndexSkipValue(json, end)) == NULL)
         {
-            break;
+            return NULL;
         }
-        
-        ALog_A(**jsonPtr == '"', "Json object parse error, char = %c, should be '\"' ", **jsonPtr);
 
-        const char* strStart;
-        int         keyLen = SkipString(jsonPtr, &strStart);
-        char        key[keyLen + 1];
-        // make string end
-        key[keyLen] = '\0';
+        int keyLength = (int) (json - key) - 1;
+        int child     = filter->paths[pathIndex].firstChild;
 
-        memcpy(key, strStart, (size_t) keyLen);
-        ALog_D("Json key = %s", key);
+        while
+        (
+            child != -1 &&
+            (
+                filter->paths[child].keyLength != keyLength ||
+                memcmp(filter->paths[child].key, key, (size_t) keyLength) != 0
+            )
+        )
+        {
+            child = filter->paths[child].nextSibling;
+        }
 
-        SkipWhiteSpace(jsonPtr);
-        ALog_A((**jsonPtr) == ':', "Json object parse error, char = %c, should be ':' ", **jsonPtr);
+        json = IndexSkipWhiteSpace(json, end);
 
-        // skip ':'
-        ++(*jsonPtr);
-        JsonValue* value = ParseValue(jsonPtr);
-        
-        // set object element
-        AArrayStrMap_TryPut(map, key, value);
+        if (json >= end || *json != ':')
+        {
+            return NULL;
+        }
 
-        SkipWhiteSpace(jsonPtr);
+        const char* value = IndexSkipWhiteSpace(json + 1, end);
 
-        if (**jsonPtr == ',')
+        if (child != -1 && value < end && *value == '{' && filter->paths[child].firstChild != -1)
         {
-            ++(*jsonPtr);
+            json = FilterScanObject(filter, child, value, end, states);
         }
         else
         {
-            ALog_A(**jsonPtr == '}', "Json Object not has '}', error char = %c ", **jsonPtr);
-            break;
+            // the values of other keys skipped without parse
+            json = IndexSkipValue(value, end);
         }
-    }
-    while (true);
 
-    // skip '}'
-    ++(*jsonPtr);
-    ALog_D("} JsonObject elements count = %d", map->elementList->size);
+        if (json == NULL)
+        {
+            return NULL;
+        }
+
+        if (child != -1 && filter->paths[child].firstCompare != -1)
+        {
+            for (int i = filter->paths[child].firstCompare; i != -1; i = filter->nodes[i].nextCompare)
+            {
+                // the first one wins when key repeated, same as parse
+                if (states[i] == JsonFilterState_Unknown)
+                {
+                    states[i] = FilterCompare(filter->nodes + i, value, json) ?
+                                JsonFilterState_True : JsonFilterState_False;
+                }
+            }
+
+            if (FilterEvaluate(filter, filter->root, states, false) != JsonFilterState_Unknown)
+            {
+                // bail out, the rest of record not scanned
+                return NULL;
+            }
+        }
+
+        json = IndexSkipWhiteSpace(json, end);
+
+        if (json < end && *json == ',')
+        {
+            json = IndexSkipWhiteSpace(json + 1, end);
+        }
+    }
 
-    return jsonValue;
+    return json < end && *json == '}' ? json + 1 : NULL;
 }
 
 
-/**
- * ParseValue changed the *jsonPtr, so if *jsonPtr is direct malloc will cause error
- */
-static JsonValue* ParseValue(const char** jsonPtr)
+static bool FilterMatch(JsonFilter* filter, const char* record, size_t length)
 {
-    SkipWhiteSpace(jsonPtr);
-
-    char c = **jsonPtr;
+    const char* end  = record + length;
+    const char* json = IndexSkipWhiteSpace(record, end);
 
-    switch (c)
+    if (json >= end || *json != '{')
     {
-        case '{':
-            return ParseObject(jsonPtr);
-
-        case '[':
-            return ParseArray(jsonPtr);
+        return false;
+    }
 
-        case '"':
-            return ParseString(jsonPtr);
+    // the states on stack, so Match is thread-safe
+    int8_t states[JsonFilter_MaxNodes];
+    memset(states, JsonFilterState_Unknown, (size_t) filter->nodeCount);
+    FilterScanObject(filter, 0, json, end, states);
 
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-        case '-':
-            return ParseNumber(jsonPtr);
+    return FilterEvaluate(filter, filter->root, states, true) == JsonFilterState_True;
+}
 
-        case 'f':
-        {
-            const char* json = *jsonPtr;
 
-            if
-            (
-                json[1] == 'a' &&
-                json[2] == 'l' &&
-                json[3] == 's' &&
-                json[4] == 'e'
-            )
-            {
-                ALog_D("Json false");
+static int FilterRun
+(
+    JsonFilter* filter,
+    const char* json,
+    size_t      length,
+    JsonParser* parser,
+    void      (*OnRecord)(void* context, const char* record, size_t length, JsonValue* value),
+    void*       context
+)
+{
+    const char* end   = json + length;
+    int         count = 0;
 
-                (*jsonPtr) += 5;
+    while (json < end)
+    {
+        const char* lineEnd = memchr(json, '\n', (size_t) (end - json));
 
-                // copy with '\0'
-                return CreateJsonValue("false", 6, JsonType_String);
-            }
-            break;
+        if (lineEnd == NULL)
+        {
+            lineEnd = end;
         }
 
-        case 't':
+        const char* record = IndexSkipWhiteSpace(json, lineEnd);
+
+        if (record < lineEnd && FilterMatch(filter, record, (size_t) (lineEnd - record)))
         {
-            const char* json = *jsonPtr;
+            const char* recordEnd = lineEnd;
 
-            if
-            (
-                json[1] == 'r' &&
-                json[2] == 'u' &&
-                json[3] == 'e'
-            )
+            // trim the white space before '\n', such as '\r'
+            while (recordEnd[-1] == ' ' || recordEnd[-1] == '\t' || recordEnd[-1] == '\r')
             {
-                ALog_D("Json true");
-
-                (*jsonPtr) += 4;
-
-                // copy with '\0'
-                return CreateJsonValue("true", 5, JsonType_String);
+                --recordEnd;
             }
-            break;
-        }
 
-        case 'n':
-        {
-            const char* json = *jsonPtr;
+            size_t     recordLength = (size_t) (recordEnd - record);
+            JsonValue* value        = NULL;
 
-            if
-            (
-                json[1] == 'u' &&
-                json[2] == 'l' &&
-                json[3] == 'l'
-            )
+            // the Match not validated the rest of record, and the json may not end with '\0',
+            // so only the complete record that ends with '}' parsed, and the parse not beyond it
+            if (parser != NULL && IndexSkipValue(record, recordEnd) == recordEnd)
             {
-                ALog_D("Json null");
+                value = ParseRoot(parser, record, recordLength);
+            }
 
-                (*jsonPtr) += 4;
+            OnRecord(context, record, recordLength, value);
 
-                // copy with '\0'
-                return CreateJsonValue("null", 5, JsonType_String);
-            }
-            break;
+            ++count;
         }
 
-        default:
-            break;
+        json = lineEnd + 1;
     }
 
-    ALog_A(false, "Invalid json value type, error char = %c", c);
-
-    return NULL;
-}
-
-
-static JsonValue* Parse(const char* jsonString)
-{
-    return ParseValue(&jsonString);
+    return count;
 }
 
 
-struct AJson AJson[1] =
+struct AJsonFilter AJsonFilter[1] =
 {{
-    Parse,
-    Destroy,
+    FilterCreate,
+    FilterDestroy,
+    FilterMatch,
+    FilterRun,
 }};
 
-
 #undef ALog_A
 #undef ALog_D
@@ -7,9 +7,9 @@
  * GitHub : https://github.com/scottcgi/MojoJson
  *
  * Since  : 2013-1-26
- * Update : 2021-2-6
+ * Update : 2026-10-18
  * Author : scott.cgi
- * Version: 1.2.3
+ * Version: 1.3.0
  */
 
  
@@ -17,6 +17,13 @@
 #define JSON_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 
 /**
@@ -46,34 +53,296 @@ typedef struct JsonArray JsonArray;
 
 
 /**
- * One json value.
+ * The layout of JsonObject and JsonArray that Json.hpp reads inline,
+ * both Json.c and Json.hpp static assert their structs against these offsets, so the changed layout fails to compile.
+ * the JsonLayout_Version increases when the layout changed.
+ */
+#define JsonLayout_Version            1
+#define JsonLayout_PointerAlign(size) (((size) + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*))
+
+/**
+ * The ArrayList holds the elements count, and the elements data pointer.
+ */
+#define JsonLayout_ListSize           (2 * sizeof(int))
+#define JsonLayout_ListData           JsonLayout_PointerAlign(3 * sizeof(int))
+#define JsonLayout_ListBytes          (JsonLayout_ListData + JsonLayout_PointerAlign(sizeof(void*) + sizeof(int)))
+
+/**
+ * The element of JsonObject holds the key, the key length include '\0', and the JsonValue pointer.
+ */
+#define JsonLayout_ElementKeyLength   sizeof(char*)
+#define JsonLayout_ElementValue       JsonLayout_PointerAlign(sizeof(char*) + sizeof(int))
+
+/**
+ * The JsonObject holds the ArrayList of elements after the value size,
+ * and the JsonArray holds the ArrayList of values then the packed type.
+ */
+#define JsonLayout_ObjectList         JsonLayout_PointerAlign(sizeof(int))
+#define JsonLayout_ArrayPackedType    JsonLayout_ListBytes
+
+
+/**
+ * For parse many json strings that reuse the memory.
+ */
+typedef struct JsonParser JsonParser;
+
+
+/**
+ * The thread-safe pool that stores each key once, and can be shared by many JsonParsers.
+ */
+typedef struct JsonKeyPool JsonKeyPool;
+
+
+/**
+ * The key stored in JsonKeyPool, the same key string has the same JsonKey.
+ */
+typedef struct
+{
+    /**
+     * End with '\0'.
+     */
+    const char* key;
+
+    /**
+     * The length of key not contains '\0'.
+     */
+    int         length;
+
+    /**
+     * The precomputed hash of key.
+     */
+    uint64_t    hash;
+}
+JsonKey;
+
+
+/**
+ * The longest key and the max keys count that JsonKeyPool stores,
+ * the pool memory is malloc and not counted by JsonParseLimits, so it is bounded by these.
+ */
+#define JsonKeyPool_MaxKeyLength 256
+#define JsonKeyPool_MaxCount     65536
+
+
+/**
+ * The dedup result of JsonParser, see AJson->SetDedup.
+ */
+typedef struct
+{
+    /**
+     * The count of long strings and subtrees that reuse the stored one.
+     */
+    int    dedupCount;
+
+    /**
+     * The bytes of memory not allocated by reusing.
+     */
+    size_t savedBytes;
+}
+JsonDedupStats;
+
+
+/**
+ * Why the last ParseWith of JsonParser returned NULL.
+ */
+typedef enum
+{
+    JsonParseError_None,
+
+    /**
+     * The json string is invalid, such as the missing ']' or unknown value.
+     */
+    JsonParseError_Syntax,
+
+    /**
+     * The allocator returned NULL.
+     */
+    JsonParseError_Memory,
+
+    /**
+     * Over the maxBytes of JsonParseLimits.
+     */
+    JsonParseError_MaxBytes,
+
+    /**
+     * Over the maxDepth of JsonParseLimits.
+     */
+    JsonParseError_MaxDepth,
+
+    /**
+     * Over the maxAllocCount or maxAllocBytes of JsonParseLimits.
+     */
+    JsonParseError_MaxAlloc,
+}
+JsonParseError;
+
+
+/**
+ * The statistics of the last ParseWith of JsonParser, see AJson->GetParseStats.
+ */
+typedef struct
+{
+    /**
+     * The bytes of json string that parsed.
+     */
+    size_t         bytes;
+
+    /**
+     * The count of values by type, the bool and null are literals, and the keys not counted as strings.
+     */
+    int            objectCount;
+    int            arrayCount;
+    int            stringCount;
+    int            numberCount;
+    int            literalCount;
+    int            keyCount;
+
+    /**
+     * The max nesting of JsonArray and JsonObject, the root container is depth 1.
+     */
+    int            maxDepth;
+
+    /**
+     * The calls and requested bytes of Alloc and Realloc of allocator,
+     * the arena blocks and stacks retained by Reset are not allocated again.
+     */
+    int            allocCount;
+    size_t         allocBytes;
+
+    /**
+     * The time of scanning json string and building JsonArray and JsonObject,
+     * only measured when AJson->SetParseTiming is true, else 0.
+     */
+    uint64_t       scanNanoseconds;
+    uint64_t       buildNanoseconds;
+
+    /**
+     * JsonParseError_None if the parse returned root JsonValue.
+     */
+    JsonParseError error;
+}
+JsonParseStats;
+
+
+/**
+ * The maxDepth of JsonParseLimits when it is 0, the parse of containers is recursive,
+ * so the default depth keeps the deep nesting json from overflowing the stack.
+ */
+#define JsonParseLimits_DefaultMaxDepth 1024
+
+
+/**
+ * The limits of each ParseWith of JsonParser, the 0 field means no limit, see AJson->SetLimits.
+ * the 0 maxDepth means JsonParseLimits_DefaultMaxDepth, and Parse also uses it.
+ */
+typedef struct
+{
+    /**
+     * The max bytes of json string.
+     */
+    size_t maxBytes;
+
+    /**
+     * The max nesting of JsonArray and JsonObject, it also bounds the recursion of parse,
+     * the bigger depth needs enough stack of the parsing thread.
+     */
+    int    maxDepth;
+
+    /**
+     * The max calls and requested bytes of Alloc and Realloc of allocator.
+     */
+    int    maxAllocCount;
+    size_t maxAllocBytes;
+}
+JsonParseLimits;
+
+
+/**
+ * The callback of trace messages, see AJson->SetTrace.
+ */
+typedef void (*JsonTrace)(void* context, const char* message);
+
+
+/**
+ * Custom memory functions for JsonParser, the context passed to each function.
+ * the Alloc and Realloc return NULL will make the parse return NULL.
  */
 typedef struct
 {
-    JsonType type;
+    void* (*Alloc)  (void* context, size_t size);
+    void* (*Realloc)(void* context, void* ptr, size_t size);
+    void  (*Free)   (void* context, void* ptr);
+
+    /**
+     * User data, such as the slab, memory pool or the memory budget of tenant.
+     */
+    void*   context;
+}
+JsonAllocator;
 
-    union
+
+/**
+ * The max length of string that stored inside JsonValue.
+ */
+#define JsonValue_ShortStringLength 14
+
+/**
+ * The byte of jsonShortString that is not 0 when JsonType_Float value is lazy number (see AJson->SetLazyNumber),
+ * it is written once when parse and never changed, so it can be read without atomic.
+ */
+#define JsonValue_LazyNumberByte    JsonValue_ShortStringLength
+
+
+/**
+ * One json value in 16 bytes, the short string, number, bool and null stored inside no need alloc memory,
+ * and the JsonArray and JsonObject hold the JsonValues directly.
+ *
+ * the bool and null are JsonType_String of "true", "false" and "null".
+ */
+typedef union
+{
+    struct
     {
-        /**
-         * For JsonType_String.
-         */
-        char*       jsonString;
+        union
+        {
+            /**
+             * For JsonType_String that longer than JsonValue_ShortStringLength,
+             * use AJson->GetString for any length string.
+             */
+            char*       jsonString;
 
-        /**
-         * For JsonType_Object.
-         */
-        JsonObject* jsonObject;
+            /**
+             * For JsonType_Object.
+             */
+            JsonObject* jsonObject;
+
+            /**
+             * For JsonType_Array.
+             */
+            JsonArray*  jsonArray;
+
+            /**
+             * For JsonType_Float and int value,
+             * the lazy number not converted in it, use GetFloat or GetInt (see AJson->SetLazyNumber).
+             */
+            float       jsonFloat;
+        };
 
         /**
-         * For JsonType_Array.
+         * Internal use, the last byte marks whether the string is jsonShortString.
          */
-        JsonArray*  jsonArray;
+        uint8_t         reserved[JsonValue_ShortStringLength + 1 - sizeof(char*)];
 
         /**
-         * For JsonType_Float and int value.
+         * The JsonType.
          */
-        float       jsonFloat;
+        uint8_t         type;
     };
+
+    /**
+     * For JsonType_String that not longer than JsonValue_ShortStringLength, end with '\0'.
+     */
+    char                jsonShortString[JsonValue_ShortStringLength + 1];
 }
 JsonValue;
 
@@ -117,6 +386,18 @@ struct AJsonObject
      * Get index of JsonObject in JsonArray map.
      */
     JsonArray*  (*GetArrayByIndex) (JsonObject* object, int index);
+
+    /**
+     * Get the raw text of lazy number (not end with '\0') and outLength, see AJson->SetLazyNumber.
+     * if not found or not lazy number return NULL.
+     */
+    const char* (*GetNumberText)   (JsonObject* object, const char* key, int* outLength);
+
+    /**
+     * Get the JsonValue by JsonKey, if the parser of object uses the same JsonKeyPool,
+     * the key compared by pointer. if not found return NULL.
+     */
+    JsonValue*  (*GetValue)        (JsonObject* object, const JsonKey* key);
 };
 
 
@@ -128,18 +409,40 @@ extern struct AJsonObject AJsonObject[1];
  */
 struct AJsonArray
 {
-    bool        (*GetBool)  (JsonArray* array, int index);
-    int         (*GetInt)   (JsonArray* array, int index);
-    float       (*GetFloat) (JsonArray* array, int index);
-    JsonType    (*GetType)  (JsonArray* array, int index);
+    bool        (*GetBool)      (JsonArray* array, int index);
+    int         (*GetInt)       (JsonArray* array, int index);
+    float       (*GetFloat)     (JsonArray* array, int index);
+    JsonType    (*GetType)      (JsonArray* array, int index);
 
     /**
      * When JsonValue released the string value will free.
      */
-    char*       (*GetString)(JsonArray* array, int index);
-    JsonObject* (*GetObject)(JsonArray* array, int index);
-    JsonArray*  (*GetArray) (JsonArray* array, int index);
+    char*       (*GetString)    (JsonArray* array, int index);
+    JsonObject* (*GetObject)    (JsonArray* array, int index);
+    JsonArray*  (*GetArray)     (JsonArray* array, int index);
+
+    /**
+     * Get the elements count of JsonArray.
+     */
+    int         (*GetCount)     (JsonArray* array);
+
+    /**
+     * Copy count numbers from index into outValues, the non-number element copied as 0,
+     * return the count of copied (not beyond the end of JsonArray).
+     *
+     * the array of only numbers is packed as int64_t or double when parse,
+     * so the copy is fast and keeps the precision of int64_t and double.
+     * the int64_t of fraction truncated toward zero, and out of range clamped to INT64_MIN or INT64_MAX.
+     */
+    int         (*CopyFloats)   (JsonArray* array, int index, int count, float*   outValues);
+    int         (*CopyDoubles)  (JsonArray* array, int index, int count, double*  outValues);
+    int         (*CopyInt64s)   (JsonArray* array, int index, int count, int64_t* outValues);
 
+    /**
+     * Get the raw text of lazy number (not end with '\0') and outLength, see AJson->SetLazyNumber.
+     * if not lazy number return NULL.
+     */
+    const char* (*GetNumberText)(JsonArray* array, int index, int* outLength);
 };
 
 
@@ -153,21 +456,701 @@ struct AJson
 {
     /**
      * Parse the Json string, return root JsonValue.
+     * the nesting deeper than JsonParseLimits_DefaultMaxDepth or invalid json returns NULL.
      */
-    JsonValue* (*Parse)    (const char* jsonString);
+    JsonValue*  (*Parse)          (const char* jsonString);
+
+    /**
+     * Parse the Json string same as Parse, and output the statistics of the parse even if returned NULL,
+     * the allocCount and allocBytes are the calls into malloc and realloc, that AJson->Destroy frees.
+     */
+    JsonValue*  (*ParseAndGetStats)(const char* jsonString, JsonParseStats* outStats);
 
 
     /**
-     * Destroy JsonValue member memory space and free itself,
-     * if Destroy root JsonValue will free all memory space.
+     * Destroy the root JsonValue from Parse, will free all memory space.
      *
      * important: after Destroy the jsonValue will be invalidated.
      */
-    void       (*Destroy)  (JsonValue* jsonValue);
+    void        (*Destroy)        (JsonValue* jsonValue);
+
+    /**
+     * Hand the root JsonValue from Parse to deferred list in O(1) lock-free,
+     * the memory freed by ReclaimDeferred later, such as on a background thread.
+     *
+     * important: after DestroyDeferred the jsonValue will be invalidated.
+     */
+    void        (*DestroyDeferred)(JsonValue* jsonValue);
+
+    /**
+     * Free all root JsonValues of DestroyDeferred by any thread, return the count of freed roots.
+     * the trees freed in a loop without recursion, so the deep tree cannot overflow the stack.
+     */
+    int         (*ReclaimDeferred)(void);
+
+    /**
+     * Get the string of JsonType_String value, the short string is inside JsonValue.
+     */
+    char*       (*GetString)      (JsonValue* jsonValue);
+
+    /**
+     * Get the float of JsonType_Float value, the lazy number converted and cached (see SetLazyNumber).
+     */
+    float       (*GetFloat)       (JsonValue* jsonValue);
+
+
+    /**
+     * Create JsonParser that keeps the arena memory blocks and parse stacks between ParseWith,
+     * so the steady state of parsing similar json strings no need malloc.
+     *
+     * allocator: all memory of parser comes from it, the struct copied into parser,
+     *            if NULL use malloc, realloc and free of C standard lib.
+     *
+     * if allocator unable to alloc memory return NULL.
+     */
+    JsonParser* (*CreateParser)   (const JsonAllocator* allocator);
+
+    /**
+     * Parse the Json string by parser, return root JsonValue that the memory owned by parser.
+     * the JsonValues of each ParseWith are valid until Reset or DestroyParser.
+     *
+     * if the allocator of parser unable to alloc memory return NULL,
+     * and the memory used by this parse released on Reset.
+     *
+     * important: cannot Destroy the JsonValue from ParseWith.
+     */
+    JsonValue*  (*ParseWith)      (JsonParser* parser, const char* jsonString);
+
+    /**
+     * Release all JsonValues of parser at once and retain the memory for next ParseWith.
+     *
+     * important: after Reset the JsonValues from parser will be invalidated.
+     */
+    void        (*Reset)          (JsonParser* parser);
+
+    /**
+     * Free all memory of parser and itself.
+     */
+    void        (*DestroyParser)  (JsonParser* parser);
+
+    /**
+     * Whether the numbers of ParseWith keep the raw text of json string, default false.
+     * the lazy number converted when first GetInt or GetFloat and cached in place,
+     * and the raw text can be get by GetNumberText for exact pass-through.
+     *
+     * important: the jsonString of ParseWith must be valid until Reset,
+     *            and the array of lazy numbers is not packed.
+     */
+    void        (*SetLazyNumber)  (JsonParser* parser, bool isLazyNumber);
+
+    /**
+     * Whether ParseWith computes the 64 bits structural hash of each JsonArray and JsonObject, default false.
+     * the hash of JsonObject not depends on keys order, and the number hashed by exact int64 or double value,
+     * so the packed and not packed arrays of same numbers have same hash, and the lazy number not converted.
+     */
+    void        (*SetHash)        (JsonParser* parser, bool isHash);
+
+    /**
+     * Get the structural hash of JsonValue, if not computed by parser then compute it without storing.
+     */
+    uint64_t    (*GetHash)        (JsonValue* jsonValue);
+
+    /**
+     * Whether two JsonValues are same structure and values, the keys order not matters.
+     * if both JsonArrays or JsonObjects have hash computed by parser, the different hashes return false in O(1),
+     * and the same hashes still compared by values.
+     */
+    bool        (*Equals)         (JsonValue* a, JsonValue* b);
+
+    /**
+     * Call OnDiff for each changed subtree from oldValue to newValue, the same hash subtrees skipped,
+     * so the changed subtree that 64 bits hash collided (about 1 in 2^64) is not reported.
+     * the path is json pointer (such as "/a/0/b") of changed value, and root path is "",
+     * the oldValue is NULL when added, and the newValue is NULL when removed.
+     *
+     * return the count of OnDiff, if unable to alloc memory return -1.
+     */
+    int         (*Diff)
+                (
+                    JsonValue* oldValue,
+                    JsonValue* newValue,
+                    void     (*OnDiff)(void* context, const char* path, JsonValue* oldValue, JsonValue* newValue),
+                    void*      context
+                );
+
+    /**
+     * Whether ParseWith stores the same long strings and subtrees once, default false.
+     * the same values share memory in parser until Reset, even in different json strings,
+     * and the hash of JsonArray and JsonObject computed as SetHash.
+     *
+     * important: the JsonArray and JsonObject may be shared by many parents.
+     */
+    void        (*SetDedup)       (JsonParser* parser, bool isDedup);
+
+    /**
+     * Get the dedup result of parser since Reset.
+     */
+    void        (*GetDedupStats)  (JsonParser* parser, JsonDedupStats* outStats);
+
+    /**
+     * Set the JsonKeyPool that the keys of JsonObject stored in, default NULL (each key stored in parser).
+     * the JsonKey in pool never released, so the hot lookup keys can be interned before parse.
+     * the key that pool not stores (too long or pool full) is stored in parser.
+     *
+     * important: the pool must be valid until the JsonValues of parser released.
+     */
+    void        (*SetKeyPool)     (JsonParser* parser, JsonKeyPool* keyPool);
+
+    /**
+     * Set the limits of each ParseWith, the limits struct copied into parser,
+     * and NULL means no limit but the JsonParseLimits_DefaultMaxDepth.
+     * over the limit the parse fails fast and returns NULL, and the error set in JsonParseStats.
+     */
+    void        (*SetLimits)      (JsonParser* parser, const JsonParseLimits* limits);
+
+    /**
+     * Whether ParseWith measures the time of scanning and building in JsonParseStats, default false.
+     * it reads the clock around each JsonArray and JsonObject building, so it slows the parse.
+     */
+    void        (*SetParseTiming) (JsonParser* parser, bool isTiming);
+
+    /**
+     * Get the statistics of the last ParseWith of parser, also after the parse returned NULL.
+     */
+    void        (*GetParseStats)  (JsonParser* parser, JsonParseStats* outStats);
+
+    /**
+     * Set the callback of trace messages of parse, the NULL callback prints messages to stdout.
+     * the trace only compiled with JSON_TRACE defined, else this function does nothing.
+     *
+     * important: the callback is global for all threads, so set it before parse.
+     */
+    void        (*SetTrace)       (JsonTrace callback, void* context);
 };
 
 
 extern struct AJson AJson[1];
 
 
+/**
+ * Control JsonKeyPool.
+ */
+struct AJsonKeyPool
+{
+    /**
+     * Create empty pool, if unable to alloc memory return NULL.
+     */
+    JsonKeyPool*   (*Create)  (void);
+
+    /**
+     * Free all JsonKeys and pool.
+     *
+     * important: no parser or JsonValue can use the pool at this moment.
+     */
+    void           (*Destroy) (JsonKeyPool* pool);
+
+    /**
+     * Thread-safe get the JsonKey of key (not need end with '\0') in pool, if not found store a new one.
+     * if the key longer than JsonKeyPool_MaxKeyLength, the pool is full or unable to alloc memory return NULL.
+     */
+    const JsonKey* (*Intern)  (JsonKeyPool* pool, const char* key, int length);
+
+    /**
+     * Get the count of JsonKeys in pool.
+     */
+    int            (*GetCount)(JsonKeyPool* pool);
+};
+
+
+extern struct AJsonKeyPool AJsonKeyPool[1];
+
+
+/**
+ * Shared immutable json document, the root JsonValue is frozen and the memory is reference counted.
+ *
+ * important: all AJsonObject and AJsonArray get functions only read the frozen values,
+ *            so they are thread-safe on any JsonValue of a JsonDoc.
+ */
+typedef struct JsonDoc     JsonDoc;
+
+
+/**
+ * Holds the current version of JsonDoc, readers acquire it without locks,
+ * and the writer publishes a new version that the old one freed when the last reader released.
+ */
+typedef struct JsonDocSlot JsonDocSlot;
+
+
+/**
+ * Control shared JsonDoc and JsonDocSlot.
+ */
+struct AJsonDoc
+{
+    /**
+     * Take ownership of the root JsonValue (from AJson->Parse) and freeze it, the reference count is 1.
+     *
+     * if unable to alloc memory return NULL, and the root is still owned by the caller.
+     *
+     * important: after Create the root must not be modified or destroyed by the caller.
+     */
+    JsonDoc*     (*Create)     (JsonValue* root);
+
+    /**
+     * Atomic increase the reference count, return the doc.
+     */
+    JsonDoc*     (*Retain)     (JsonDoc* doc);
+
+    /**
+     * Atomic decrease the reference count, the last Release will destroy the root JsonValue and free doc.
+     */
+    void         (*Release)    (JsonDoc* doc);
+
+    /**
+     * Get the frozen root JsonValue.
+     */
+    JsonValue*   (*GetRoot)    (JsonDoc* doc);
+
+    /**
+     * Create slot that take ownership of the caller's reference of doc, the doc can be NULL.
+     * if unable to alloc memory return NULL, and the reference of doc is still owned by the caller.
+     */
+    JsonDocSlot* (*CreateSlot) (JsonDoc* doc);
+
+    /**
+     * Release the current doc and free slot.
+     *
+     * important: no reader or writer can use the slot at this moment.
+     */
+    void         (*DestroySlot)(JsonDocSlot* slot);
+
+    /**
+     * Lock-free get and retain the current doc of slot, the caller must Release it after use.
+     * if slot is empty return NULL.
+     */
+    JsonDoc*     (*Acquire)    (JsonDocSlot* slot);
+
+    /**
+     * Atomic swap the current doc of slot with new doc (take ownership of the caller's reference),
+     * then wait for the readers that may see the old doc to finish Acquire, and release the old doc.
+     * the old doc will be freed when the last reader released it.
+     *
+     * concurrent Publish calls are serialized, the doc can be NULL.
+     */
+    void         (*Publish)    (JsonDocSlot* slot, JsonDoc* doc);
+};
+
+
+extern struct AJsonDoc AJsonDoc[1];
+
+
+/**
+ * The bounded cache of shared JsonDocs keyed by the bytes of json string, the least recently used evicted first.
+ */
+typedef struct JsonCache JsonCache;
+
+
+/**
+ * The counters of JsonCache, see AJsonCache->GetStats.
+ */
+typedef struct
+{
+    /**
+     * The count of Parse that returned cached doc, or parsed json.
+     */
+    int64_t hitCount;
+    int64_t missCount;
+
+    /**
+     * The count of docs evicted by memory budget.
+     */
+    int64_t evictCount;
+
+    /**
+     * The count of cached docs, and their bytes of json copies and parsed JsonValues.
+     */
+    int     docCount;
+    size_t  usedBytes;
+}
+JsonCacheStats;
+
+
+/**
+ * Control JsonCache that identical json strings skip parsing.
+ */
+struct AJsonCache
+{
+    /**
+     * Create JsonCache that the cached docs not more than maxBytes,
+     * the bytes of doc are the copy of json string and the memory of parsed JsonValues.
+     *
+     * if unable to alloc memory return NULL.
+     */
+    JsonCache* (*Create)  (size_t maxBytes);
+
+    /**
+     * Release all cached docs and free cache, the docs held by callers are valid until they Release.
+     */
+    void       (*Destroy) (JsonCache* cache);
+
+    /**
+     * Get the shared JsonDoc of same json string from cache, or parse it by AJson->Parse and cache it.
+     * the returned doc is retained for caller that must AJsonDoc->Release it after use,
+     * and the root JsonValue is frozen that must not be modified.
+     *
+     * the cache is thread-safe, the same json parsed outside lock, and the bytes compared on hit.
+     * if the json invalid or unable to alloc memory return NULL.
+     */
+    JsonDoc*   (*Parse)   (JsonCache* cache, const char* jsonString);
+
+    /**
+     * Get the counters of cache.
+     */
+    void       (*GetStats)(JsonCache* cache, JsonCacheStats* outStats);
+};
+
+
+extern struct AJsonCache AJsonCache[1];
+
+
+
+/**
+ * The value type of JsonColumn.
+ */
+typedef enum
+{
+    /**
+     * The values is double[maxRows].
+     */
+    JsonColumnType_Float64,
+
+    /**
+     * The values is int64_t[maxRows].
+     */
+    JsonColumnType_Int64,
+
+    /**
+     * The values is uint8_t[maxRows] that 1 is true and 0 is false.
+     */
+    JsonColumnType_Bool,
+
+    /**
+     * The values is int[maxRows] of offsets in stringData, and lengths is int[maxRows].
+     */
+    JsonColumnType_String,
+}
+JsonColumnType;
+
+
+/**
+ * The values of one key in json array of objects, the buffers provided by caller.
+ */
+typedef struct
+{
+    /**
+     * The key of object, end with '\0'.
+     */
+    const char*    key;
+
+    JsonColumnType type;
+
+    /**
+     * The buffer of values, the element type depends on JsonColumnType.
+     */
+    void*          values;
+
+    /**
+     * For JsonColumnType_String, the buffer of string lengths.
+     */
+    int*           lengths;
+
+    /**
+     * The bit of row is 1 when the value is null, missing or not matched type, the bytes is (maxRows + 7) / 8.
+     * the null value set to 0 or empty string, and the nullBitmap can be NULL.
+     */
+    uint8_t*       nullBitmap;
+
+    /**
+     * For JsonColumnType_String, the buffer of strings (not end with '\0') that each row copied into.
+     */
+    char*          stringData;
+
+    /**
+     * The bytes of stringData.
+     */
+    int            stringCapacity;
+
+    /**
+     * Output the bytes of all strings, if bigger than stringCapacity,
+     * the strings not fit are null and need retry with bigger stringData.
+     */
+    int            stringSize;
+}
+JsonColumn;
+
+
+/**
+ * Extract the json array of objects into columns.
+ */
+struct AJsonColumn
+{
+    /**
+     * Fill columns from the JsonArray of JsonObjects, the element not JsonObject is all null row.
+     * the key index of object is resolved once and reused by records with same keys.
+     * the json null is null in all columns, and the Int64 column is null for not integral number
+     * or number out of int64 range.
+     *
+     * the number of JsonValue is float, so the Int64 and Float64 columns are exact only when
+     * the array parsed with AJson->SetLazyNumber, that the raw text parsed as FromJson.
+     *
+     * return the rows count, not bigger than maxRows.
+     */
+    int (*FromArray)(JsonArray* array, JsonColumn* columns, int columnCount, int maxRows);
+
+    /**
+     * Fill columns from the json string of array of objects without creating JsonValue,
+     * the key ordinals of record is resolved once and reused by records with same keys order.
+     *
+     * return the rows count, not bigger than maxRows,
+     * or -1 when the json is not an array or incomplete or has unexpected char in records.
+     */
+    int (*FromJson) (const char* json,  JsonColumn* columns, int columnCount, int maxRows);
+};
+
+
+extern struct AJsonColumn AJsonColumn[1];
+
+
+/**
+ * The sidecar index of records in huge json array or NDJSON, such as mmap file,
+ * for random access the record by index or by the value of key.
+ */
+typedef struct JsonIndex JsonIndex;
+
+
+/**
+ * Build, save, load JsonIndex and parse the indexed record.
+ */
+struct AJsonIndex
+{
+    /**
+     * Build JsonIndex in one pass of json that not beyond length,
+     * the json is an array of records or NDJSON (the records separated by white space).
+     *
+     * key: if not NULL, each object record maps the raw value of top-level key to record index,
+     *      the string value not contains quotes and the escaped chars keep original.
+     *
+     * if the json record is incomplete or unable to alloc memory return NULL.
+     */
+    JsonIndex* (*Build)      (const char* json, size_t length, const char* key);
+
+    /**
+     * Save JsonIndex into file, the file can only be loaded on same endian machine.
+     * if unable to write file return false.
+     */
+    bool       (*Save)       (JsonIndex* index, const char* filePath);
+
+    /**
+     * Load JsonIndex from file of Save, if unable to read file or alloc memory return NULL.
+     */
+    JsonIndex* (*Load)       (const char* filePath);
+
+    /**
+     * Free all memory of JsonIndex.
+     */
+    void       (*Destroy)    (JsonIndex* index);
+
+    /**
+     * Check the json is the one index built from, by the length and the hash of leading bytes.
+     * the loaded index should be checked before use, the offsets of other json are meaningless.
+     */
+    bool       (*IsSource)   (JsonIndex* index, const char* json, size_t length);
+
+    /**
+     * Get the count of records.
+     */
+    int        (*GetCount)   (JsonIndex* index);
+
+    /**
+     * Get the byte offset and length of record in the json index built from, if record out of range return false.
+     */
+    bool       (*GetRecord)  (JsonIndex* index, int record, size_t* outOffset, size_t* outLength);
+
+    /**
+     * Find the first record that the raw value of key matched, the json and jsonLength are same as Build,
+     * the key value beyond jsonLength is not matched. if not found return -1.
+     */
+    int        (*FindKey)    (JsonIndex* index, const char* json, size_t jsonLength, const char* value, int length);
+
+    /**
+     * Parse one record of json (same as Build) by AJson->Parse, return root JsonValue that free by AJson->Destroy,
+     * the parse not beyond the record length.
+     *
+     * if record out of range, beyond jsonLength or incomplete return NULL.
+     */
+    JsonValue* (*ParseRecord)(JsonIndex* index, const char* json, size_t jsonLength, int record);
+};
+
+
+extern struct AJsonIndex AJsonIndex[1];
+
+
+/**
+ * The streaming formatter that minifies or indents json without JsonValue, in constant memory.
+ */
+typedef struct JsonFormat JsonFormat;
+
+
+/**
+ * Create JsonFormat and write json chunks into it.
+ */
+struct AJsonFormat
+{
+    /**
+     * Create JsonFormat with fixed output buffer, if unable to alloc memory return NULL.
+     *
+     * indent : 0 minifies json, or the count of spaces for each level of indented json.
+     * OnWrite: called with formatted bytes when output buffer is full and on Finish.
+     */
+    JsonFormat* (*Create)
+                (
+                    int     indent,
+                    void  (*OnWrite)(void* context, const char* data, size_t length),
+                    void*   context
+                );
+
+    /**
+     * Format the chunk of json, the string, number and literal can be split by chunks.
+     * the json is not validated, if the brackets are unbalanced return false.
+     */
+    bool        (*Write)  (JsonFormat* format, const char* json, size_t length);
+
+    /**
+     * Flush output of all written chunks, and ready for next json.
+     * if the json is incomplete or Write failed return false.
+     */
+    bool        (*Finish) (JsonFormat* format);
+
+    /**
+     * Free the memory of JsonFormat.
+     */
+    void        (*Destroy)(JsonFormat* format);
+};
+
+
+extern struct AJsonFormat AJsonFormat[1];
+
+
+/**
+ * The binary format of AJsonPack.
+ */
+typedef enum
+{
+    /**
+     * The container header is the smallest size of count.
+     */
+    JsonPackFormat_MessagePack,
+
+    /**
+     * The container is indefinite length.
+     */
+    JsonPackFormat_CBOR,
+}
+JsonPackFormat;
+
+
+/**
+ * Transcode between json and MessagePack or CBOR in one pass without JsonValue.
+ *
+ * the output length is same as snprintf, if the returned length greater than capacity,
+ * the buffer is too small and the call can be retried with the returned capacity.
+ */
+struct AJsonPack
+{
+    /**
+     * Transcode json not beyond length into buffer.
+     * the integer number packed as int, others as float64, and the escaped chars of string are decoded into UTF-8.
+     *
+     * if the json is invalid return 0.
+     */
+    size_t (*FromJson)(JsonPackFormat packFormat, const char* json, size_t length, char* buffer, size_t capacity);
+
+    /**
+     * Transcode data not beyond length into minified json in buffer, the json ends with '\0' when length < capacity.
+     * the key of map must be string, and the binary and extension types are not supported.
+     *
+     * if the data is invalid or unsupported return 0.
+     */
+    size_t (*ToJson)  (JsonPackFormat packFormat, const char* data, size_t length, char* buffer, size_t capacity);
+};
+
+
+extern struct AJsonPack AJsonPack[1];
+
+
+/**
+ * The compiled predicate that matches the raw NDJSON records without JsonValue.
+ */
+typedef struct JsonFilter JsonFilter;
+
+
+/**
+ * Compile predicate and filter the records that only the matched ones parsed or passed through.
+ */
+struct AJsonFilter
+{
+    /**
+     * Compile the predicate expression, if the expression invalid or unable to alloc memory return NULL.
+     *
+     * expression: the comparisons of field path and literal joined by "&&" and "||" with parentheses,
+     *             such as: level == "error" && (code >= 500 || user.name != "bot"),
+     *             the path keys separated by '.', and the key with special chars in quotes like "a.b".c,
+     *             the operators are ==, !=, <, <=, >, >=, and the literals are string, number, true, false, null.
+     *
+     * the string compared as raw text of json that the escaped chars keep original,
+     * and the missing field compares false, the different types only != true.
+     */
+    JsonFilter* (*Create) (const char* expression);
+
+    /**
+     * Free the memory of JsonFilter.
+     */
+    void        (*Destroy)(JsonFilter* filter);
+
+    /**
+     * Whether the record not beyond length matches the predicate, only the object record can match.
+     * the record scanned raw until the result decided, so the rest of record not scanned or validated.
+     *
+     * the filter is not changed by Match, so it can be used by many threads.
+     */
+    bool        (*Match)  (JsonFilter* filter, const char* record, size_t length);
+
+    /**
+     * Match each record of NDJSON (one record per line) not beyond length, and call OnRecord with the matched one.
+     *
+     * parser: if not NULL, the matched record parsed by AJson->ParseWith and the value passed to OnRecord,
+     *         the value is NULL when the record incomplete or the parse failed;
+     *         if NULL, the value is NULL and record passed through.
+     *
+     * return the count of matched records.
+     */
+    int         (*Run)
+                (
+                    JsonFilter* filter,
+                    const char* json,
+                    size_t      length,
+                    JsonParser* parser,
+                    void      (*OnRecord)(void* context, const char* record, size_t length, JsonValue* value),
+                    void*       context
+                );
+};
+
+
+extern struct AJsonFilter AJsonFilter[1];
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
 #endif
@@ -0,0 +1,706 @@
+/*
+ * Copyright (c) scott.cgi All Rights Reserved.
+ *
+ * This source code belongs to project MojoJson, which is hosted on GitHub, and licensed under the MIT License.
+ *
+ * License: https://github.com/scottcgi/MojoJson/blob/master/LICENSE
+ * GitHub : https://github.com/scottcgi/MojoJson
+ *
+ * Since  : 2026-10-18
+ * Author : scott.cgi
+ * Version: 1.3.0
+ */
+
+
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "Json.h"
+
+
+/**
+ * The header-only C++17 view of JsonValue.
+ *
+ * the accessors read JsonValue, JsonArray and JsonObject directly and can be inlined,
+ * only the lazy number calls into AJson->GetFloat for conversion.
+ */
+namespace json
+{
+    class value;
+    class object;
+    class array;
+
+
+    namespace detail
+    {
+        /**
+         * The layout of ArrayList, ArrayStrMap, JsonObject and JsonArray in Json.c, keep them same.
+         */
+        struct List
+        {
+            int increase;
+            int elementTypeSize;
+            int size;
+
+            struct
+            {
+                void* data;
+                int   length;
+            }
+            elementArr[1];
+        };
+
+
+        struct MapElement
+        {
+            const char* key;
+            int         keyLength; // include '\0'
+            void*       valuePtr;
+        };
+
+
+        struct Map
+        {
+            int  valueTypeSize;
+            List elementList[1];
+        };
+
+
+        struct Object
+        {
+            Map           valueMap[1];
+            std::uint64_t hash;
+        };
+
+
+        struct Array
+        {
+            List          valueList[1];
+            int           packedType;
+            std::uint64_t hash;
+        };
+
+
+        enum
+        {
+            Packed_None,
+            Packed_Int64,
+            Packed_Double,
+        };
+
+
+        /**
+         * The byte of short string length and long string mark.
+         */
+        constexpr int          StringLengthByte = JsonValue_ShortStringLength;
+        constexpr std::uint8_t LongStringMark   = 0xFF;
+
+
+        static_assert(sizeof(JsonValue) == 16, "JsonValue must be 16 bytes");
+        static_assert(JsonLayout_Version == 1, "the mirrors written for JsonLayout_Version 1");
+
+        static_assert(offsetof(List, size)                  == JsonLayout_ListSize,         "List layout changed");
+        static_assert(offsetof(List, elementArr)            == JsonLayout_ListData,         "List layout changed");
+        static_assert(sizeof  (List)                        == JsonLayout_ListBytes,        "List layout changed");
+        static_assert(offsetof(MapElement, keyLength)       == JsonLayout_ElementKeyLength, "MapElement layout changed");
+        static_assert(offsetof(MapElement, valuePtr)        == JsonLayout_ElementValue,     "MapElement layout changed");
+        static_assert(offsetof(Map, elementList)            == JsonLayout_ObjectList,       "Object layout changed");
+        static_assert(offsetof(Object, valueMap)            == 0,                           "Object layout changed");
+        static_assert(offsetof(Array, packedType)           == JsonLayout_ArrayPackedType,  "Array layout changed");
+
+
+        /**
+         * Whether the number is lazy, the lazy byte written once by parse, so the plain load is race-free.
+         */
+        inline bool IsLazyNumber(const JsonValue* cell)
+        {
+            return cell->jsonShortString[JsonValue_LazyNumberByte] != 0;
+        }
+
+
+        inline const List* GetList(const JsonObject* object)
+        {
+            return reinterpret_cast<const Object*>(object)->valueMap->elementList;
+        }
+
+
+        inline const List* GetList(const JsonArray* array)
+        {
+            return reinterpret_cast<const Array*>(array)->valueList;
+        }
+
+
+        /**
+         * Binary search same as ArrayStrMap, the keys sorted by length then bytes.
+         */
+        inline int Search(const JsonObject* object, std::string_view key)
+        {
+            const List*              list      = GetList(object);
+            const MapElement* const* elements  = static_cast<const MapElement* const*>(list->elementArr->data);
+            int                      keyLength = static_cast<int>(key.size()) + 1;
+            int                      low       = 0;
+            int                      high      = list->size;
+
+            while (low < high)
+            {
+                int               mid     = (low + high) >> 1;
+                const MapElement* element = elements[mid];
+                int               cmp     = element->keyLength != keyLength ?
+                                            element->keyLength -  keyLength :
+                                            std::memcmp(element->key, key.data(), key.size());
+
+                if (cmp == 0)
+                {
+                    return mid;
+                }
+
+                if (cmp < 0)
+                {
+                    low  = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+
+            return -1;
+        }
+    }
+
+
+    /**
+     * The compile-time key, the length computed from string literal.
+     */
+    class key
+    {
+    public:
+        constexpr explicit key(std::string_view name) : name(name) {}
+
+        constexpr std::string_view get_name()   const { return name;        }
+        constexpr std::size_t      get_length() const { return name.size(); }
+
+    private:
+        std::string_view name;
+    };
+
+
+    namespace literals
+    {
+        /**
+         * The key from string literal, such as "id"_key.
+         */
+        constexpr key operator""_key(const char* str, std::size_t length)
+        {
+            return key(std::string_view(str, length));
+        }
+    }
+
+
+    /**
+     * The view of JsonValue not owned, or the element of packed JsonArray, or missing.
+     */
+    class value
+    {
+    public:
+        constexpr value() = default;
+
+        constexpr explicit value(const JsonValue* cell) : cell(cell) {}
+
+        constexpr value(const JsonArray* packed, int index) : packed(packed), index(index) {}
+
+        /**
+         * Whether the value exists.
+         */
+        constexpr explicit operator bool() const
+        {
+            return cell != nullptr || packed != nullptr;
+        }
+
+        /**
+         * The JsonType_Null when missing.
+         */
+        JsonType type() const
+        {
+            if (cell != nullptr)
+            {
+                return static_cast<JsonType>(cell->type);
+            }
+
+            return packed != nullptr ? JsonType_Float : JsonType_Null;
+        }
+
+        /**
+         * Whether missing or the json null, that stored as string "null".
+         */
+        bool is_null() const
+        {
+            return type() == JsonType_Null || get_string() == "null";
+        }
+
+        bool is_string() const
+        {
+            return type() == JsonType_String;
+        }
+
+        bool is_number() const
+        {
+            return type() == JsonType_Float;
+        }
+
+        bool is_object() const
+        {
+            return type() == JsonType_Object;
+        }
+
+        bool is_array() const
+        {
+            return type() == JsonType_Array;
+        }
+
+        /**
+         * The raw JsonValue, nullptr when missing or packed.
+         */
+        constexpr const JsonValue* get_cell() const
+        {
+            return cell;
+        }
+
+        /**
+         * Get T of bool, arithmetic, std::string_view, const char*, json::object or json::array,
+         * the T{} or empty view when the type not matched.
+         */
+        template <typename T>
+        T get() const;
+
+        /**
+         * Get T, or the defaultValue when the type not matched.
+         */
+        template <typename T>
+        T get(T defaultValue) const
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                return is_string() && is_bool() ? get<bool>() : defaultValue;
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                return is_number() ? get<T>() : defaultValue;
+            }
+            else
+            {
+                return is_string() ? get<T>() : defaultValue;
+            }
+        }
+
+        inline value operator[](std::string_view key) const;
+        inline value operator[](const key& key)       const;
+        inline value operator[](int index)            const;
+
+    private:
+        const JsonValue* cell   = nullptr;
+        const JsonArray* packed = nullptr;
+        int              index  = 0;
+
+        std::string_view get_string() const
+        {
+            if (is_string() == false)
+            {
+                return {};
+            }
+
+            std::uint8_t mark = static_cast<std::uint8_t>(cell->jsonShortString[detail::StringLengthByte]);
+
+            if (mark == detail::LongStringMark)
+            {
+                return cell->jsonString;
+            }
+
+            return std::string_view(cell->jsonShortString, static_cast<std::size_t>(JsonValue_ShortStringLength - mark));
+        }
+
+        bool is_bool() const
+        {
+            std::string_view str = get_string();
+            return str == "true" || str == "false";
+        }
+
+        double get_double() const
+        {
+            if (packed != nullptr)
+            {
+                const detail::Array* array = reinterpret_cast<const detail::Array*>(packed);
+                const void*          data  = array->valueList->elementArr->data;
+
+                if (array->packedType == detail::Packed_Int64)
+                {
+                    return static_cast<double>(static_cast<const std::int64_t*>(data)[index]);
+                }
+
+                return static_cast<const double*>(data)[index];
+            }
+
+            if (is_number() == false)
+            {
+                return 0.0;
+            }
+
+            // the eager number is never changed, the lazy number converted and cached by C code
+            if (detail::IsLazyNumber(cell) == false)
+            {
+                return cell->jsonFloat;
+            }
+
+            return AJson->GetFloat(const_cast<JsonValue*>(cell));
+        }
+
+        template <typename T>
+        T get_integer() const
+        {
+            if (packed != nullptr)
+            {
+                const detail::Array* array = reinterpret_cast<const detail::Array*>(packed);
+
+                if (array->packedType == detail::Packed_Int64)
+                {
+                    return static_cast<T>(static_cast<const std::int64_t*>(array->valueList->elementArr->data)[index]);
+                }
+            }
+
+            return static_cast<T>(get_double());
+        }
+    };
+
+
+    /**
+     * The view of JsonObject, the iteration yields std::pair of key and value in the order of keys.
+     */
+    class object
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<std::string_view, json::value>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = value_type;
+
+            iterator(const detail::MapElement* const* elements, int index) : elements(elements), index(index) {}
+
+            value_type operator*() const
+            {
+                const detail::MapElement* element = elements[index];
+
+                return value_type
+                (
+                    std::string_view(element->key, static_cast<std::size_t>(element->keyLength - 1)),
+                    json::value(static_cast<const JsonValue*>(element->valuePtr))
+                );
+            }
+
+            iterator& operator++()
+            {
+                ++index;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator it = *this;
+                ++index;
+                return it;
+            }
+
+            bool operator==(const iterator& other) const { return index == other.index; }
+            bool operator!=(const iterator& other) const { return index != other.index; }
+
+        private:
+            const detail::MapElement* const* elements;
+            int                              index;
+        };
+
+
+        constexpr object() = default;
+
+        constexpr explicit object(const JsonObject* jsonObject) : jsonObject(jsonObject) {}
+
+        constexpr explicit operator bool() const
+        {
+            return jsonObject != nullptr;
+        }
+
+        constexpr const JsonObject* get() const
+        {
+            return jsonObject;
+        }
+
+        int size() const
+        {
+            return jsonObject != nullptr ? detail::GetList(jsonObject)->size : 0;
+        }
+
+        bool contains(std::string_view key) const
+        {
+            return jsonObject != nullptr && detail::Search(jsonObject, key) != -1;
+        }
+
+        /**
+         * The missing value when key not found.
+         */
+        value operator[](std::string_view key) const
+        {
+            if (jsonObject == nullptr)
+            {
+                return {};
+            }
+
+            int index = detail::Search(jsonObject, key);
+
+            if (index == -1)
+            {
+                return {};
+            }
+
+            return value(static_cast<const JsonValue*>(get_elements()[index]->valuePtr));
+        }
+
+        value operator[](const key& key) const
+        {
+            return (*this)[key.get_name()];
+        }
+
+        iterator begin() const
+        {
+            return iterator(get_elements(), 0);
+        }
+
+        iterator end() const
+        {
+            return iterator(get_elements(), size());
+        }
+
+    private:
+        const JsonObject* jsonObject = nullptr;
+
+        const detail::MapElement* const* get_elements() const
+        {
+            if (jsonObject == nullptr)
+            {
+                return nullptr;
+            }
+
+            return static_cast<const detail::MapElement* const*>(detail::GetList(jsonObject)->elementArr->data);
+        }
+    };
+
+
+    /**
+     * The view of JsonArray, the iteration yields json::value.
+     */
+    class array
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = json::value;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = value_type;
+
+            iterator(const array* owner, int index) : owner(owner), index(index) {}
+
+            value_type operator*() const
+            {
+                return (*owner)[index];
+            }
+
+            iterator& operator++()
+            {
+                ++index;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator it = *this;
+                ++index;
+                return it;
+            }
+
+            bool operator==(const iterator& other) const { return index == other.index; }
+            bool operator!=(const iterator& other) const { return index != other.index; }
+
+        private:
+            const array* owner;
+            int          index;
+        };
+
+
+        constexpr array() = default;
+
+        constexpr explicit array(const JsonArray* jsonArray) : jsonArray(jsonArray) {}
+
+        constexpr explicit operator bool() const
+        {
+            return jsonArray != nullptr;
+        }
+
+        constexpr const JsonArray* get() const
+        {
+            return jsonArray;
+        }
+
+        int size() const
+        {
+            return jsonArray != nullptr ? detail::GetList(jsonArray)->size : 0;
+        }
+
+        /**
+         * The missing value when index out of range.
+         */
+        value operator[](int index) const
+        {
+            if (index < 0 || index >= size())
+            {
+                return {};
+            }
+
+            const detail::Array* list = reinterpret_cast<const detail::Array*>(jsonArray);
+
+            if (list->packedType != detail::Packed_None)
+            {
+                return value(jsonArray, index);
+            }
+
+            return value(static_cast<const JsonValue*>(list->valueList->elementArr->data) + index);
+        }
+
+        iterator begin() const
+        {
+            return iterator(this, 0);
+        }
+
+        iterator end() const
+        {
+            return iterator(this, size());
+        }
+
+    private:
+        const JsonArray* jsonArray = nullptr;
+    };
+
+
+    template <typename T>
+    T value::get() const
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            return get_string() == "true";
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return get_integer<T>();
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return static_cast<T>(get_double());
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            return get_string();
+        }
+        else if constexpr (std::is_same_v<T, const char*>)
+        {
+            return is_string() ? AJson->GetString(const_cast<JsonValue*>(cell)) : nullptr;
+        }
+        else if constexpr (std::is_same_v<T, object>)
+        {
+            return is_object() ? object(cell->jsonObject) : object();
+        }
+        else if constexpr (std::is_same_v<T, array>)
+        {
+            return is_array() ? array(cell->jsonArray) : array();
+        }
+        else
+        {
+            static_assert(sizeof(T) == 0, "json::value::get<T> not supported type");
+        }
+    }
+
+
+    value value::operator[](std::string_view key) const
+    {
+        return get<object>()[key];
+    }
+
+
+    value value::operator[](const key& key) const
+    {
+        return get<object>()[key];
+    }
+
+
+    value value::operator[](int index) const
+    {
+        return get<array>()[index];
+    }
+
+
+    /**
+     * The owner of root JsonValue from AJson->Parse, destroyed with AJson->Destroy.
+     */
+    class document
+    {
+    public:
+        explicit document(const char* jsonString) : root(AJson->Parse(jsonString)) {}
+
+        document(const document&)            = delete;
+        document& operator=(const document&) = delete;
+
+        document(document&& other) noexcept : root(other.root)
+        {
+            other.root = nullptr;
+        }
+
+        document& operator=(document&& other) noexcept
+        {
+            std::swap(root, other.root);
+            return *this;
+        }
+
+        ~document()
+        {
+            if (root != nullptr)
+            {
+                AJson->Destroy(root);
+            }
+        }
+
+        value get() const
+        {
+            return value(root);
+        }
+
+        value operator[](std::string_view key) const { return get()[key];   }
+        value operator[](const key& key)       const { return get()[key];   }
+        value operator[](int index)            const { return get()[index]; }
+
+    private:
+        JsonValue* root;
+    };
+}
+
+
+#endif
@@ -7,11 +7,12 @@
  * GitHub : https://github.com/scottcgi/MojoJson
  *
  * Since  : 2017-9-6
- * Update : 2020-2-28
+ * Update : 2026-10-18
  * Author : scott.cgi
- * Version: 1.2.3
+ * Version: 1.3.0
  */
 
+using System.Buffers.Text;
 using System.Collections.Generic;
 using System.Text;
 using System;
@@ -20,9 +21,9 @@ namespace MojoJson
 {
     public static class Json 
     {
-        private const  int  ObjectInitCapacity = 8;
-        private const  int  ArrayInitCapacity  = 8;
-        private static bool isEscapeString;
+        private const   int  ObjectInitCapacity = 8;
+        private const   int  ArrayInitCapacity  = 8;
+        internal static bool isEscapeString;
 
 
         #region Parse Json API
@@ -35,6 +36,28 @@ namespace MojoJson
             return ParseValue(ref data);
         }
 
+        /// <summary>
+        /// Parse UTF-8 json bytes into the pooled JsonStore without decoding into string,
+        /// the values are structs indexed in store, and the string decoded only when AsString.
+        /// the JsonStore must be Dispose to return into pool, then all JsonNodes of it are invalid.
+        /// </summary>
+        public static JsonStore Parse(ReadOnlySpan<byte> utf8Json)
+        {
+            var store = JsonStore.Rent();
+
+            try
+            {
+                store.Load(utf8Json);
+            }
+            catch
+            {
+                store.Dispose();
+                throw;
+            }
+
+            return store;
+        }
+
         /// <summary>
         /// Whether the string value need to be escaped ?
         /// </summary>
@@ -933,6 +956,963 @@ namespace MojoJson
     }
 
 
+    /// <summary>
+    /// The value in JsonStore, the string and key are byte ranges of json,
+    /// and the JsonObject and JsonArray are ranges of children indexes.
+    /// </summary>
+    internal struct JsonEntry
+    {
+        public JsonType type;
+
+        /// <summary>
+        /// The byte offset and length of string without quotes,
+        /// or the start and count in children of JsonObject and JsonArray.
+        /// </summary>
+        public int      start;
+        public int      length;
+
+        /// <summary>
+        /// The byte offset and length of key without quotes, if not in JsonObject the keyStart is -1.
+        /// </summary>
+        public int      keyStart;
+        public int      keyLength;
+
+        /// <summary>
+        /// The number, and the bool is 1.0f or 0.0f.
+        /// </summary>
+        public float    number;
+
+        /// <summary>
+        /// Whether the string has escaped char.
+        /// </summary>
+        public bool     hasEscape;
+    }
+
+
+    /// <summary>
+    /// The parsed UTF-8 json that all values stored in reused arrays, and rented from pool by Json.Parse.
+    /// the steady state of parsing similar json no need alloc, except the strings of AsString.
+    /// the JsonStore and its JsonNodes are used by one thread at a time.
+    /// </summary>
+    public sealed class JsonStore : IDisposable
+    {
+        private const  int               InitCapacity = 64;
+        private const  int               PoolCapacity = 16;
+        private static readonly Stack<JsonStore> pool = new Stack<JsonStore>(PoolCapacity);
+
+        internal byte[]      bytes    = new byte     [InitCapacity * 16];
+        internal int         length;
+        internal JsonEntry[] entries  = new JsonEntry[InitCapacity];
+        internal int         entryCount;
+
+        /// <summary>
+        /// The children indexes of each JsonObject and JsonArray are together.
+        /// </summary>
+        internal int[]       children = new int      [InitCapacity];
+        internal int         childCount;
+
+        /// <summary>
+        /// The children indexes of parsing containers, each container uses the top range.
+        /// </summary>
+        private  int[]       stack    = new int      [InitCapacity];
+        private  int         stackCount;
+
+        /// <summary>
+        /// The decoded strings by entry index, cleared when Dispose.
+        /// </summary>
+        private  string[]    strings  = new string   [InitCapacity];
+
+        /// <summary>
+        /// The unescaped UTF-8 bytes of string.
+        /// </summary>
+        private  byte[]      unescaped;
+
+        private  bool        isRented;
+
+        /// <summary>
+        /// Increased when Dispose, the JsonNode of old generation cannot read the reused store.
+        /// </summary>
+        internal int         generation;
+
+
+        private JsonStore()
+        {
+        }
+
+
+        /// <summary>
+        /// The root JsonNode.
+        /// </summary>
+        public JsonNode Root
+        {
+            get
+            {
+                if (this.isRented == false)
+                {
+                    throw new ObjectDisposedException(nameof(JsonStore));
+                }
+
+                return new JsonNode(this, 0);
+            }
+        }
+
+
+        /// <summary>
+        /// Return into pool, the buffers retained for next Parse.
+        /// </summary>
+        public void Dispose()
+        {
+            if (this.isRented == false)
+            {
+                return;
+            }
+
+            this.isRented = false;
+            ++this.generation;
+
+            // the strings can be collected
+            Array.Clear(this.strings, 0, Math.Min(this.entryCount, this.strings.Length));
+
+            lock (JsonStore.pool)
+            {
+                if (JsonStore.pool.Count < JsonStore.PoolCapacity)
+                {
+                    JsonStore.pool.Push(this);
+                }
+            }
+        }
+
+
+        internal static JsonStore Rent()
+        {
+            JsonStore store = null;
+
+            lock (JsonStore.pool)
+            {
+                if (JsonStore.pool.Count > 0)
+                {
+                    store = JsonStore.pool.Pop();
+                }
+            }
+
+            if (store == null)
+            {
+                store = new JsonStore();
+            }
+
+            store.isRented = true;
+
+            return store;
+        }
+
+
+        #region Parse UTF-8 Json
+        /// <summary>
+        /// Copy the json into bytes and parse all values into entries.
+        /// </summary>
+        internal void Load(ReadOnlySpan<byte> utf8Json)
+        {
+            if (this.bytes.Length < utf8Json.Length + 1)
+            {
+                this.bytes = new byte[Math.Max(utf8Json.Length + 1, this.bytes.Length * 2)];
+            }
+
+            utf8Json.CopyTo(this.bytes);
+
+            // the end sentinel same as '\0' of C string
+            this.length             = utf8Json.Length;
+            this.bytes[this.length] = 0;
+            this.entryCount         = 0;
+            this.childCount         = 0;
+            this.stackCount         = 0;
+
+            var index = 0;
+            this.ParseValue(ref index, -1, 0);
+        }
+
+
+        /// <summary>
+        /// Parse the value into new entry, return the entry index.
+        /// </summary>
+        private int ParseValue(ref int index, int keyStart, int keyLength)
+        {
+            this.SkipWhiteSpace(ref index);
+
+            if (this.entryCount == this.entries.Length)
+            {
+                Array.Resize(ref this.entries, this.entries.Length * 2);
+            }
+
+            var entryIndex = this.entryCount++;
+
+            // the entries may be resized by children, so always access by index
+            this.entries[entryIndex] = new JsonEntry
+            {
+                keyStart  = keyStart,
+                keyLength = keyLength,
+            };
+
+            switch (this.bytes[index])
+            {
+                case (byte) '{':
+                    this.ParseContainer(ref index, entryIndex, JsonType.Object, (byte) '}');
+                    return entryIndex;
+
+                case (byte) '[':
+                    this.ParseContainer(ref index, entryIndex, JsonType.Array,  (byte) ']');
+                    return entryIndex;
+
+                case (byte) '"':
+                {
+                    var start = index + 1;
+                    index     = this.ScanString(start, out bool hasEscape);
+
+                    this.entries[entryIndex].type      = JsonType.String;
+                    this.entries[entryIndex].start     = start;
+                    this.entries[entryIndex].length    = index - start;
+                    this.entries[entryIndex].hasEscape = hasEscape;
+
+                    // skip '"'
+                    ++index;
+                    return entryIndex;
+                }
+
+                case (byte) '0':
+                case (byte) '1':
+                case (byte) '2':
+                case (byte) '3':
+                case (byte) '4':
+                case (byte) '5':
+                case (byte) '6':
+                case (byte) '7':
+                case (byte) '8':
+                case (byte) '9':
+                case (byte) '-':
+                {
+                    var span = new ReadOnlySpan<byte>(this.bytes, index, this.length - index);
+
+                    if (Utf8Parser.TryParse(span, out float number, out int bytesConsumed) == false)
+                    {
+                        throw new Exception(string.Format("Json ParseNumber error, index at '{0}' ", index));
+                    }
+
+                    index                          += bytesConsumed;
+                    this.entries[entryIndex].type   = JsonType.Number;
+                    this.entries[entryIndex].number = number;
+                    return entryIndex;
+                }
+
+                case (byte) 'f':
+                    if
+                    (
+                        this.bytes[index + 1] == 'a' &&
+                        this.bytes[index + 2] == 'l' &&
+                        this.bytes[index + 3] == 's' &&
+                        this.bytes[index + 4] == 'e'
+                    )
+                    {
+                        index                        += 5;
+                        this.entries[entryIndex].type = JsonType.Bool;
+                        return entryIndex;
+                    }
+                    break;
+
+                case (byte) 't':
+                    if
+                    (
+                        this.bytes[index + 1] == 'r' &&
+                        this.bytes[index + 2] == 'u' &&
+                        this.bytes[index + 3] == 'e'
+                    )
+                    {
+                        index                          += 4;
+                        this.entries[entryIndex].type   = JsonType.Bool;
+                        this.entries[entryIndex].number = 1.0f;
+                        return entryIndex;
+                    }
+                    break;
+
+                case (byte) 'n':
+                    if
+                    (
+                        this.bytes[index + 1] == 'u' &&
+                        this.bytes[index + 2] == 'l' &&
+                        this.bytes[index + 3] == 'l'
+                    )
+                    {
+                        index                        += 4;
+                        this.entries[entryIndex].type = JsonType.Null;
+                        return entryIndex;
+                    }
+                    break;
+            }
+
+            throw new Exception
+            (
+                string.Format
+                (
+                    "Json ParseValue error on char '{0}' index at '{1}' ",
+                    (char) this.bytes[index],
+                    index
+                )
+            );
+        }
+
+
+        /// <summary>
+        /// Parse JsonObject or JsonArray, the children indexes push into stack first,
+        /// then copy into children with exact count.
+        /// </summary>
+        private void ParseContainer(ref int index, int entryIndex, JsonType type, byte endChar)
+        {
+            var stackBase = this.stackCount;
+
+            // skip '{' or '['
+            ++index;
+
+            do
+            {
+                this.SkipWhiteSpace(ref index);
+
+                if (this.bytes[index] == endChar)
+                {
+                    break;
+                }
+
+                var keyStart  = -1;
+                var keyLength = 0;
+
+                if (type == JsonType.Object)
+                {
+                    if (this.bytes[index] != '"')
+                    {
+                        throw new Exception
+                        (
+                            string.Format("Json ParseObject error, char '{0}' should be '\"' ", (char) this.bytes[index])
+                        );
+                    }
+
+                    keyStart  = index + 1;
+                    index     = this.ScanString(keyStart, out bool _);
+                    keyLength = index - keyStart;
+
+                    // skip '"'
+                    ++index;
+                    this.SkipWhiteSpace(ref index);
+
+                    if (this.bytes[index] != ':')
+                    {
+                        throw new Exception
+                        (
+                            string.Format("Json ParseObject error, char '{0}' should be ':' ", (char) this.bytes[index])
+                        );
+                    }
+
+                    // skip ':'
+                    ++index;
+                }
+
+                var childIndex = this.ParseValue(ref index, keyStart, keyLength);
+
+                if (this.stackCount == this.stack.Length)
+                {
+                    Array.Resize(ref this.stack, this.stack.Length * 2);
+                }
+
+                this.stack[this.stackCount++] = childIndex;
+                this.SkipWhiteSpace(ref index);
+
+                if (this.bytes[index] == ',')
+                {
+                    ++index;
+                }
+                else if (this.bytes[index] == endChar)
+                {
+                    break;
+                }
+                else
+                {
+                    throw new Exception
+                    (
+                        string.Format
+                        (
+                            "Json Parse{0} error, char '{1}' should be '{2}' ",
+                            type,
+                            (char) this.bytes[index],
+                            (char) endChar
+                        )
+                    );
+                }
+            }
+            while (true);
+
+            // skip '}' or ']'
+            ++index;
+
+            var count = this.stackCount - stackBase;
+
+            if (this.childCount + count > this.children.Length)
+            {
+                Array.Resize(ref this.children, Math.Max(this.childCount + count, this.children.Length * 2));
+            }
+
+            Array.Copy(this.stack, stackBase, this.children, this.childCount, count);
+
+            this.entries[entryIndex].type   = type;
+            this.entries[entryIndex].start  = this.childCount;
+            this.entries[entryIndex].length = count;
+            this.childCount                += count;
+            this.stackCount                 = stackBase;
+        }
+
+
+        /// <summary>
+        /// Find the end '"' of string from start, return the index of end '"'.
+        /// </summary>
+        private int ScanString(int start, out bool hasEscape)
+        {
+            var index = start;
+            hasEscape = false;
+
+            while (index < this.length)
+            {
+                // vectorized search of quote and backslash
+                var found = new ReadOnlySpan<byte>(this.bytes, index, this.length - index).IndexOfAny
+                            (
+                                (byte) '"',
+                                (byte) '\\'
+                            );
+
+                if (found < 0)
+                {
+                    break;
+                }
+
+                index += found;
+
+                if (this.bytes[index] == '"')
+                {
+                    return index;
+                }
+
+                // skip the escaped char, it may be '"'
+                hasEscape = true;
+                index    += 2;
+            }
+
+            throw new Exception(string.Format("Json string not has end '\"', start at index '{0}' ", start));
+        }
+
+
+        private void SkipWhiteSpace(ref int index)
+        {
+            while (true)
+            {
+                switch (this.bytes[index])
+                {
+                    case (byte) ' ' :
+                    case (byte) '\t':
+                    case (byte) '\n':
+                    case (byte) '\r':
+                        ++index;
+                        continue;
+                }
+
+                // index point to non-whitespace
+                break;
+            }
+        }
+        #endregion
+
+
+        #region Lazy String
+        /// <summary>
+        /// Get the string of entry, decoded on first get and cached until Dispose.
+        /// </summary>
+        internal string GetString(int entryIndex)
+        {
+            if (this.strings.Length < this.entryCount)
+            {
+                Array.Resize(ref this.strings, this.entries.Length);
+            }
+
+            var str = this.strings[entryIndex];
+
+            if (str == null)
+            {
+                var entry = this.entries[entryIndex];
+
+                if (entry.hasEscape && Json.isEscapeString)
+                {
+                    str = Encoding.UTF8.GetString(this.unescaped, 0, this.Unescape(entry.start, entry.length));
+                }
+                else
+                {
+                    str = Encoding.UTF8.GetString(this.bytes, entry.start, entry.length);
+                }
+
+                this.strings[entryIndex] = str;
+            }
+
+            return str;
+        }
+
+
+        /// <summary>
+        /// Unescape the string bytes into unescaped, return the count of unescaped bytes.
+        /// </summary>
+        private int Unescape(int start, int length)
+        {
+            // the unescaped is not longer than escaped
+            if (this.unescaped == null || this.unescaped.Length < length)
+            {
+                this.unescaped = new byte[Math.Max(length, InitCapacity * 16)];
+            }
+
+            var end   = start + length;
+            var count = 0;
+
+            for (var i = start; i < end; ++i)
+            {
+                var b = this.bytes[i];
+
+                if (b != '\\')
+                {
+                    this.unescaped[count++] = b;
+                    continue;
+                }
+
+                switch (this.bytes[++i])
+                {
+                    case (byte) 'b':
+                        b = (byte) '\b';
+                        break;
+
+                    case (byte) 'f':
+                        b = (byte) '\f';
+                        break;
+
+                    case (byte) 'n':
+                        b = (byte) '\n';
+                        break;
+
+                    case (byte) 'r':
+                        b = (byte) '\r';
+                        break;
+
+                    case (byte) 't':
+                        b = (byte) '\t';
+                        break;
+
+                    case (byte) 'u':
+                    {
+                        var codePoint = this.GetHex4(i + 1);
+                        i            += 4;
+
+                        // the surrogate pair is two escaped code units
+                        if
+                        (
+                            codePoint >= 0xD800 && codePoint <= 0xDBFF &&
+                            i + 6 < end && this.bytes[i + 1] == '\\' && this.bytes[i + 2] == 'u'
+                        )
+                        {
+                            var low = this.GetHex4(i + 3);
+
+                            if (low >= 0xDC00 && low <= 0xDFFF)
+                            {
+                                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                                i        += 6;
+                            }
+                        }
+
+                        count += this.WriteUtf8(codePoint, count);
+                        continue;
+                    }
+
+                    default:
+                        // '"', '\\', '/' and '\'' are themselves
+                        b = this.bytes[i];
+                        break;
+                }
+
+                this.unescaped[count++] = b;
+            }
+
+            return count;
+        }
+
+
+        private int GetHex4(int index)
+        {
+            var value = 0;
+
+            for (var i = index; i < index + 4; ++i)
+            {
+                int c = this.bytes[i];
+
+                if (c >= '0' && c <= '9')
+                {
+                    c -= '0';
+                }
+                else if (c >= 'a' && c <= 'f')
+                {
+                    c -= 'a' - 10;
+                }
+                else if (c >= 'A' && c <= 'F')
+                {
+                    c -= 'A' - 10;
+                }
+                else
+                {
+                    throw new Exception(string.Format("Json Unicode char '{0}' error", (char) c));
+                }
+
+                value = (value << 4) | c;
+            }
+
+            return value;
+        }
+
+
+        /// <summary>
+        /// Write code point into unescaped at index, return the count of bytes,
+        /// the "\\uXXXX" is 6 bytes so the UTF-8 bytes not longer than it.
+        /// </summary>
+        private int WriteUtf8(int codePoint, int index)
+        {
+            var buffer = this.unescaped;
+
+            if (codePoint < 0x80)
+            {
+                buffer[index] = (byte) codePoint;
+                return 1;
+            }
+
+            if (codePoint < 0x800)
+            {
+                buffer[index    ] = (byte) (0xC0 | (codePoint >> 6));
+                buffer[index + 1] = (byte) (0x80 | (codePoint & 0x3F));
+                return 2;
+            }
+
+            if (codePoint < 0x10000)
+            {
+                buffer[index    ] = (byte) (0xE0 | (codePoint >> 12));
+                buffer[index + 1] = (byte) (0x80 | ((codePoint >> 6) & 0x3F));
+                buffer[index + 2] = (byte) (0x80 | (codePoint & 0x3F));
+                return 3;
+            }
+
+            buffer[index    ] = (byte) (0xF0 | (codePoint >> 18));
+            buffer[index + 1] = (byte) (0x80 | ((codePoint >> 12) & 0x3F));
+            buffer[index + 2] = (byte) (0x80 | ((codePoint >> 6)  & 0x3F));
+            buffer[index + 3] = (byte) (0x80 | (codePoint & 0x3F));
+            return 4;
+        }
+
+
+        /// <summary>
+        /// Whether the raw key of entry equals key, the escaped chars of raw key keep original.
+        /// </summary>
+        internal bool KeyEquals(int entryIndex, string key)
+        {
+            var entry = this.entries[entryIndex];
+
+            // the UTF-8 bytes not less than UTF-16 chars
+            if (entry.keyLength < key.Length)
+            {
+                return false;
+            }
+
+            var keyBytes = new ReadOnlySpan<byte>(this.bytes, entry.keyStart, entry.keyLength);
+
+            if (keyBytes.Length == key.Length)
+            {
+                // same length only when all chars are ASCII
+                for (var i = 0; i < key.Length; ++i)
+                {
+                    if (keyBytes[i] != key[i] || keyBytes[i] >= 0x80)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            Span<byte> buffer = key.Length <= 128 ? stackalloc byte[384] : new byte[key.Length * 3];
+            var        count  = Encoding.UTF8.GetBytes(key.AsSpan(), buffer);
+
+            return keyBytes.SequenceEqual((ReadOnlySpan<byte>) buffer.Slice(0, count));
+        }
+        #endregion
+    }
+
+
+    /// <summary>
+    /// The value view of JsonStore, it is valid until the JsonStore Dispose,
+    /// then using it throws ObjectDisposedException even if the store reused by next Parse.
+    /// the default JsonNode is not found value that IsValid false.
+    /// </summary>
+    public readonly struct JsonNode
+    {
+        private readonly JsonStore store;
+        private readonly int       index;
+
+        /// <summary>
+        /// The generation of store when JsonNode created.
+        /// </summary>
+        private readonly int       generation;
+
+
+        internal JsonNode(JsonStore store, int index)
+        {
+            this.store      = store;
+            this.index      = index;
+            this.generation = store.generation;
+        }
+
+
+        /// <summary>
+        /// Whether the JsonNode is found.
+        /// </summary>
+        public bool IsValid
+        {
+            get
+            {
+                return this.store != null;
+            }
+        }
+
+
+        public JsonType Type
+        {
+            get
+            {
+                return this.Store.entries[this.index].type;
+            }
+        }
+
+
+        /// <summary>
+        /// The count of k-v pairs of JsonObject or elements of JsonArray.
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                DebugTool.Assert(this.IsContainer(), "JsonNode type is not Object or Array !");
+                return this.Store.entries[this.index].length;
+            }
+        }
+
+
+        #region JsonObject API
+        /// <summary>
+        /// Use JsonNode as JsonObject and get JsonNode item by key.
+        /// return default JsonNode (IsValid false) if not found key.
+        /// </summary>
+        public JsonNode AsObjectGet(string key)
+        {
+            var store   = this.Store;
+            var entries = store.entries;
+            DebugTool.Assert(entries[this.index].type == JsonType.Object, "JsonNode type is not Object !");
+
+            var start = entries[this.index].start;
+            var end   = start + entries[this.index].length;
+
+            // the first one wins when key repeated
+            for (var i = start; i < end; ++i)
+            {
+                var childIndex = store.children[i];
+
+                if (store.KeyEquals(childIndex, key))
+                {
+                    return new JsonNode(store, childIndex);
+                }
+            }
+
+            return default(JsonNode);
+        }
+
+
+        /// <summary>
+        /// Use JsonNode as JsonObject and get string item by key.
+        /// return null if not found key.
+        /// </summary>
+        public string AsObjectGetString(string key)
+        {
+            var node = this.AsObjectGet(key);
+            return node.IsValid ? node.AsString() : null;
+        }
+
+
+        /// <summary>
+        /// Use JsonNode as JsonObject and get float item by key.
+        /// return defaultValue if not found key.
+        /// </summary>
+        public float AsObjectGetFloat(string key, float defaultValue)
+        {
+            var node = this.AsObjectGet(key);
+            return node.IsValid ? node.AsFloat() : defaultValue;
+        }
+
+
+        /// <summary>
+        /// Use JsonNode as JsonObject and get int item by key.
+        /// return defaultValue if not found key.
+        /// </summary>
+        public int AsObjectGetInt(string key, int defaultValue)
+        {
+            var node = this.AsObjectGet(key);
+            return node.IsValid ? node.AsInt() : defaultValue;
+        }
+
+
+        /// <summary>
+        /// Use JsonNode as JsonObject and get bool item by key.
+        /// return defaultValue if not found key.
+        /// </summary>
+        public bool AsObjectGetBool(string key, bool defaultValue)
+        {
+            var node = this.AsObjectGet(key);
+            return node.IsValid ? node.AsBool() : defaultValue;
+        }
+
+
+        /// <summary>
+        /// Use JsonNode as JsonObject and check null item by key.
+        /// </summary>
+        public bool AsObjectGetIsNull(string key)
+        {
+            var node = this.AsObjectGet(key);
+            return node.IsValid && node.IsNull();
+        }
+
+
+        /// <summary>
+        /// Get the key of JsonNode in JsonObject, the string allocated for each call.
+        /// return null if not in JsonObject.
+        /// </summary>
+        public string GetKey()
+        {
+            var store = this.Store;
+            var entry = store.entries[this.index];
+            return entry.keyStart < 0 ? null : Encoding.UTF8.GetString(store.bytes, entry.keyStart, entry.keyLength);
+        }
+        #endregion
+
+
+        #region JsonArray API
+        /// <summary>
+        /// Get JsonNode item of JsonArray or JsonObject by index, the item of JsonObject has key.
+        /// </summary>
+        public JsonNode this[int index]
+        {
+            get
+            {
+                var store = this.Store;
+                var entry = store.entries[this.index];
+
+                DebugTool.Assert(this.IsContainer(), "JsonNode type is not Object or Array !");
+
+                if ((uint) index >= (uint) entry.length)
+                {
+                    throw new IndexOutOfRangeException();
+                }
+
+                return new JsonNode(store, store.children[entry.start + index]);
+            }
+        }
+
+
+        /// <summary>
+        /// Use JsonNode as JsonArray and get JsonNode item by index.
+        /// </summary>
+        public JsonNode AsArrayGet(int index)
+        {
+            DebugTool.Assert(this.Store.entries[this.index].type == JsonType.Array, "JsonNode type is not Array !");
+            return this[index];
+        }
+        #endregion
+
+
+        #region Other Json Node API
+        /// <summary>
+        /// Get JsonNode as string, decoded from UTF-8 on first get.
+        /// </summary>
+        public string AsString()
+        {
+            DebugTool.Assert(this.Type == JsonType.String, "JsonNode type is not String !");
+            return this.Store.GetString(this.index);
+        }
+
+
+        /// <summary>
+        /// Get JsonNode as float.
+        /// </summary>
+        public float AsFloat()
+        {
+            DebugTool.Assert(this.Type == JsonType.Number, "JsonNode type is not Number !");
+            return this.Store.entries[this.index].number;
+        }
+
+
+        /// <summary>
+        /// Get JsonNode as int.
+        /// </summary>
+        public int AsInt()
+        {
+            DebugTool.Assert(this.Type == JsonType.Number, "JsonNode type is not Number !");
+            return (int) this.Store.entries[this.index].number;
+        }
+
+
+        /// <summary>
+        /// Get JsonNode as bool.
+        /// </summary>
+        public bool AsBool()
+        {
+            DebugTool.Assert(this.Type == JsonType.Bool, "JsonNode type is not Bool !");
+            return this.Store.entries[this.index].number > 0.0f;
+        }
+
+
+        /// <summary>
+        /// Whether JsonNode is null ？
+        /// </summary>
+        public bool IsNull()
+        {
+            return this.Type == JsonType.Null;
+        }
+
+
+        /// <summary>
+        /// The store of JsonNode, throw ObjectDisposedException if the store disposed after JsonNode created.
+        /// </summary>
+        private JsonStore Store
+        {
+            get
+            {
+                if (this.store.generation != this.generation)
+                {
+                    throw new ObjectDisposedException(nameof(JsonStore), "JsonNode used after JsonStore Dispose !");
+                }
+
+                return this.store;
+            }
+        }
+
+
+        private bool IsContainer()
+        {
+            var type = this.Store.entries[this.index].type;
+            return type == JsonType.Object || type == JsonType.Array;
+        }
+        #endregion
+    }
+
+
     internal static class DebugTool
     {
         public static void Assert(bool condition, string msg, params object[] args)
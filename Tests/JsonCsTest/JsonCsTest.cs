@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) scott.cgi All Rights Reserved.
+ *
+ * This source code belongs to project MojoJson, which is hosted on GitHub, and licensed under the MIT License.
+ *
+ * License: https://github.com/scottcgi/MojoJson/blob/master/LICENSE
+ * GitHub : https://github.com/scottcgi/MojoJson
+ *
+ * Since  : 2026-10-18
+ * Author : scott.cgi
+ * Version: 1.3.0
+ */
+
+using System.Runtime.CompilerServices;
+using System.Text;
+using System;
+using MojoJson;
+
+
+/// <summary>
+/// The correctness test of MojoJson.cs, and the exit code is the failed count.
+/// </summary>
+public static class JsonCsTest
+{
+    private static int checkCount;
+    private static int failCount;
+
+
+    private static void Check(bool condition, [CallerLineNumber] int line = 0)
+    {
+        ++checkCount;
+
+        if (condition == false)
+        {
+            ++failCount;
+            Console.WriteLine("JsonCsTest.cs:{0}: check failed", line);
+        }
+    }
+
+
+    private static void TestParseString()
+    {
+        var value = Json.Parse("{\"id\": 42, \"name\": \"mojo\", \"list\": [1, 2.5, true, null]}");
+
+        Check(value.AsObjectGetInt("id", 0)                  == 42);
+        Check(value.AsObjectGetString("name")                == "mojo");
+        Check(value.AsObjectGetArray("list").Count           == 4);
+        Check(value.AsObjectGetArray("list")[1].AsFloat()    == 2.5f);
+    }
+
+
+    private static void TestParseUtf8()
+    {
+        var utf8 = Encoding.UTF8.GetBytes("{\"id\": 42, \"name\": \"\u00e9t\u00e9 \\u0041\", \"list\": [1, 2.5, true, null], \"o\": {}}");
+
+        using (var store = Json.Parse((ReadOnlySpan<byte>) utf8))
+        {
+            var root = store.Root;
+            var list = root.AsObjectGet("list");
+
+            Check(root.Type                            == JsonType.Object && root.Count == 4);
+            Check(root.AsObjectGetInt("id", 0)         == 42);
+            Check(root.AsObjectGetString("name")       == "\u00e9t\u00e9 \\u0041");
+            Check(root.AsObjectGet("missing").IsValid  == false);
+            Check(list.Count                           == 4);
+            Check(list[1].AsFloat()                    == 2.5f && list[2].AsBool() && list[3].IsNull());
+            Check(root[1].GetKey()                     == "name");
+            Check(root.AsObjectGet("o").Count          == 0);
+        }
+    }
+
+
+    private static void TestDisposedNode()
+    {
+        var     store = Json.Parse((ReadOnlySpan<byte>) Encoding.UTF8.GetBytes("[1, 2]"));
+        JsonNode node = store.Root;
+
+        Check(node.Type == JsonType.Array);
+        store.Dispose();
+
+        // the pooled store reused by next Parse, but the old node cannot read it
+        using (var reused = Json.Parse((ReadOnlySpan<byte>) Encoding.UTF8.GetBytes("{\"z\": \"q\"}")))
+        {
+            Check(reused.Root.AsObjectGetString("z") == "q");
+
+            try
+            {
+                var type = node.Type;
+                Check(false);
+            }
+            catch (ObjectDisposedException)
+            {
+                Check(true);
+            }
+        }
+    }
+
+
+    public static int Main()
+    {
+        TestParseString();
+        TestParseUtf8();
+        TestDisposedNode();
+
+        Console.WriteLine("JsonCsTest: {0} checks, {1} failed", checkCount, failCount);
+
+        return failCount;
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) scott.cgi All Rights Reserved.
+ *
+ * This source code belongs to project MojoJson, which is hosted on GitHub, and licensed under the MIT License.
+ *
+ * License: https://github.com/scottcgi/MojoJson/blob/master/LICENSE
+ * GitHub : https://github.com/scottcgi/MojoJson
+ *
+ * Since  : 2026-10-18
+ * Author : scott.cgi
+ * Version: 1.3.0
+ */
+
+
+/**
+ * The correctness test of Json.hpp, and the exit code is the failed count.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "../Json.hpp"
+
+
+using namespace json::literals;
+
+
+static int checkCount = 0;
+static int failCount  = 0;
+
+
+#define Test_Check(e)                                                                  \
+    (                                                                                  \
+        ++checkCount,                                                                  \
+        (e) ? (void) 0 :                                                               \
+        (void) (++failCount, std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #e)) \
+    )
+
+
+static_assert("id"_key.get_length() == 2, "the key length computed at compile time");
+
+
+static void TestValue()
+{
+    json::document doc
+    (
+        R"({"id": 42, "name": "short", "long": "the string longer than 14", "t": true, "n": null,
+            "nums": [1, 2, 3], "dbl": [1.5, 2.5], "mix": [1, "x", {"k": 7}], "o": {"a": 1, "bb": 2, "c": 3}})"
+    );
+
+    Test_Check(doc["id"].get<int>()                         == 42);
+    Test_Check(doc["id"_key].get<std::int64_t>()            == 42);
+    Test_Check(doc["name"].get<std::string_view>()          == "short");
+    Test_Check(doc["long"].get<std::string_view>()          == "the string longer than 14");
+    Test_Check(std::string(doc["long"].get<const char*>())  == "the string longer than 14");
+    Test_Check(doc["t"].get<bool>()                         == true);
+    Test_Check(doc["n"].is_null() && doc["missing"].is_null());
+    Test_Check(!doc["missing"] && doc["missing"].get<int>(7) == 7);
+    Test_Check(doc["nums"][1].get<int>()                    == 2);
+    Test_Check(doc["dbl"][1].get<double>()                  == 2.5);
+    Test_Check(doc["mix"][2]["k"].get<float>()              == 7.0f);
+    Test_Check(!doc["mix"][9]);
+}
+
+
+static void TestIteration()
+{
+    json::document doc(R"({"nums": [1, 2, 3], "o": {"a": 1, "bb": 2, "c": 3}})");
+    int            sum = 0;
+    std::string    keys;
+
+    for (json::value value : doc["nums"].get<json::array>())
+    {
+        sum += value.get<int>();
+    }
+
+    for (auto [key, value] : doc["o"].get<json::object>())
+    {
+        keys += key;
+        sum  += value.get<int>();
+    }
+
+    json::object object = doc["o"].get<json::object>();
+
+    Test_Check(sum == 12 && keys.size() == 4);
+    Test_Check(object.size() == 3 && object.contains("bb") && !object.contains("b"));
+}
+
+
+static void TestLazyNumber()
+{
+    JsonParser* parser = AJson->CreateParser(nullptr);
+
+    AJson->SetLazyNumber(parser, true);
+
+    json::value root(AJson->ParseWith(parser, R"({"x": 3.25, "y": [1, 2]})"));
+
+    Test_Check(root["x"].get<double>() == 3.25);
+    Test_Check(root["x"].get<double>() == 3.25);
+    Test_Check(root["y"][1].get<int>() == 2);
+
+    // the lazy byte written once by parse, and not changed when the lazy number cached
+    JsonValue* lazy  = AJson->ParseWith(parser, "2.5");
+    JsonValue* eager = AJson->Parse("2.5");
+
+    Test_Check(json::detail::IsLazyNumber(lazy) && json::detail::IsLazyNumber(eager) == false);
+    Test_Check(json::value(lazy).get<double>() == 2.5 && json::value(eager).get<double>() == 2.5);
+    Test_Check(json::detail::IsLazyNumber(lazy));
+
+    AJson->Destroy(eager);
+    AJson->DestroyParser(parser);
+}
+
+
+int main()
+{
+    TestValue();
+    TestIteration();
+    TestLazyNumber();
+
+    std::printf("JsonHppTest: %d checks, %d failed\n", checkCount, failCount);
+
+    return failCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,727 @@
+/*
+ * Copyright (c) scott.cgi All Rights Reserved.
+ *
+ * This source code belongs to project MojoJson, which is hosted on GitHub, and licensed under the MIT License.
+ *
+ * License: https://github.com/scottcgi/MojoJson/blob/master/LICENSE
+ * GitHub : https://github.com/scottcgi/MojoJson
+ *
+ * Since  : 2026-10-18
+ * Author : scott.cgi
+ * Version: 1.3.0
+ */
+
+
+/**
+ * The correctness test of Json.c, each TestXxx checks one API group, and the exit code is the failed count.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../Json.h"
+
+
+static int checkCount = 0;
+static int failCount  = 0;
+
+
+/**
+ * Not use assert, so the test also checks the build with NDEBUG.
+ */
+#define Test_Check(e)                                                             \
+    (                                                                             \
+        ++checkCount,                                                             \
+        (e) ? (void) 0 :                                                          \
+        (void) (++failCount, printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #e)) \
+    )
+
+
+static void TestParse(void)
+{
+    const char* json  = "{\"i\": 7, \"f\": -1.5e3, \"s\": \"short\", \"l\": \"the string longer than 14\","
+                        " \"b\": true, \"n\": null, \"o\": {\"k\": [1, \"x\", {}]}, \"e\": [ ]}";
+    JsonValue*  value = AJson->Parse(json);
+
+    Test_Check(value != NULL && value->type == JsonType_Object);
+
+    JsonObject* object = value->jsonObject;
+
+    Test_Check(AJsonObject->GetInt   (object, "i", 0)            == 7);
+    Test_Check(AJsonObject->GetFloat (object, "f", 0.0f)         == -1500.0f);
+    Test_Check(AJsonObject->GetBool  (object, "b", false)        == true);
+    Test_Check(AJsonObject->GetInt   (object, "missing", 3)      == 3);
+    Test_Check(strcmp(AJsonObject->GetString(object, "s", ""), "short")                     == 0);
+    Test_Check(strcmp(AJsonObject->GetString(object, "l", ""), "the string longer than 14") == 0);
+    Test_Check(strcmp(AJsonObject->GetString(object, "n", ""), "null")                      == 0);
+
+    JsonArray* array = AJsonObject->GetArray(AJsonObject->GetObject(object, "o"), "k");
+
+    Test_Check(AJsonArray->GetCount(array)                          == 3);
+    Test_Check(AJsonArray->GetInt(array, 0)                         == 1);
+    Test_Check(strcmp(AJsonArray->GetString(array, 1), "x")        == 0);
+    Test_Check(AJsonArray->GetType(array, 2)                        == JsonType_Object);
+    Test_Check(AJsonArray->GetCount(AJsonObject->GetArray(object, "e")) == 0);
+
+    AJson->Destroy(value);
+}
+
+
+static void TestPackedArray(void)
+{
+    JsonValue* value = AJson->Parse("[[9007199254740993, -5, 0], [1, 0.1, 3], [1, 2.5, \"x\"]]");
+    JsonArray* array = value->jsonArray;
+    int64_t    int64s [4];
+    double     doubles[4];
+    float      floats [4];
+
+    Test_Check(AJsonArray->CopyInt64s (AJsonArray->GetArray(array, 0), 0, 4, int64s)  == 3);
+    Test_Check(int64s[0] == 9007199254740993LL && int64s[1] == -5);
+
+    Test_Check(AJsonArray->CopyDoubles(AJsonArray->GetArray(array, 1), 1, 4, doubles) == 2);
+    Test_Check(doubles[0] == 0.1 && doubles[1] == 3.0);
+
+    Test_Check(AJsonArray->CopyFloats (AJsonArray->GetArray(array, 2), 0, 4, floats)  == 3);
+    Test_Check(floats[1] == 2.5f && floats[2] == 0.0f);
+
+    AJson->Destroy(value);
+
+    // the out of range double clamped
+    value = AJson->Parse("[1e300, -1e300, 2.5]");
+
+    Test_Check(AJsonArray->CopyInt64s(value->jsonArray, 0, 4, int64s) == 3);
+    Test_Check(int64s[0] == INT64_MAX && int64s[1] == INT64_MIN && int64s[2] == 2);
+
+    AJson->Destroy(value);
+}
+
+
+static void TestParser(void)
+{
+    const char* json   = "{\"a\": 12345678901234567890, \"b\": -1.5e3, \"c\": [1, 2.25]}";
+    JsonParser* parser = AJson->CreateParser(NULL);
+    int         length;
+
+    AJson->SetLazyNumber(parser, true);
+
+    JsonValue*  value  = AJson->ParseWith(parser, json);
+    JsonObject* object = value->jsonObject;
+    const char* text   = AJsonObject->GetNumberText(object, "a", &length);
+
+    Test_Check(text != NULL && length == 20 && memcmp(text, "12345678901234567890", 20) == 0);
+    Test_Check(AJsonObject->GetFloat(object, "b", 0.0f)                  == -1500.0f);
+    Test_Check(AJsonArray->GetFloat(AJsonObject->GetArray(object, "c"), 1) == 2.25f);
+
+    AJson->Reset(parser);
+
+    value = AJson->ParseWith(parser, "2.5");
+    Test_Check(AJson->GetFloat(value) == 2.5f);
+
+    AJson->Reset(parser);
+    AJson->SetLazyNumber(parser, false);
+
+    value = AJson->ParseWith(parser, json);
+
+    Test_Check(AJsonObject->GetNumberText(value->jsonObject, "b", &length) == NULL);
+    Test_Check(AJsonObject->GetFloat(value->jsonObject, "b", 0.0f)        == -1500.0f);
+
+    AJson->DestroyParser(parser);
+}
+
+
+static char diffLog[256];
+
+
+static void OnDiff(void* context, const char* path, JsonValue* oldValue, JsonValue* newValue)
+{
+    (void) context;
+
+    size_t length = strlen(diffLog);
+
+    snprintf
+    (
+        diffLog + length,
+        sizeof(diffLog) - length,
+        "%s:%c%c;",
+        path,
+        oldValue != NULL ? 'o' : '-',
+        newValue != NULL ? 'n' : '-'
+    );
+}
+
+
+static void TestHashDiff(void)
+{
+    JsonParser* parser = AJson->CreateParser(NULL);
+
+    AJson->SetHash(parser, true);
+
+    JsonValue* a = AJson->ParseWith(parser, "{\"x\": 1, \"y\": {\"p\": [1, 2], \"q\": \"s\"}, \"z\": [{\"k\": true}, 5]}");
+    JsonValue* b = AJson->ParseWith(parser, "{\"y\": {\"q\": \"s\", \"p\": [1, 2]}, \"x\": 1.0, \"z\": [{\"k\": true}, 5]}");
+    JsonValue* c = AJson->Parse        (        "{\"y\": {\"q\": \"t\", \"p\": [1, 2]}, \"x\": 1, \"z\": [{\"k\": false}], \"n\": 0}");
+
+    Test_Check(AJson->GetHash(a) == AJson->GetHash(b));
+    Test_Check(AJson->Equals(a, b) == true);
+    Test_Check(AJson->Equals(a, c) == false);
+    Test_Check(AJson->Diff  (a, b, OnDiff, NULL) == 0);
+
+    diffLog[0] = '\0';
+
+    Test_Check(AJson->Diff(a, c, OnDiff, NULL) == 4);
+    Test_Check(strcmp(diffLog, "/y/q:on;/z/0/k:on;/z/1:o-;/n:-n;") == 0);
+
+    // the packed int64 beyond float are hashed and compared exactly
+    a = AJson->ParseWith(parser, "[9007199254740993, 1]");
+    b = AJson->ParseWith(parser, "[9007199254740992, 1]");
+
+    Test_Check(AJson->GetHash(a) != AJson->GetHash(b));
+    Test_Check(AJson->Equals(a, b) == false);
+    Test_Check(AJson->Diff  (a, b, OnDiff, NULL) == 1);
+
+    AJson->Destroy(c);
+    c = AJson->Parse("[9007199254740993, 1]");
+
+    Test_Check(AJson->Equals(a, c) == true);
+    Test_Check(AJson->Equals(b, c) == false);
+
+    // the lazy numbers hashed by raw text as same as packed numbers
+    JsonParser* lazyParser = AJson->CreateParser(NULL);
+
+    AJson->SetHash      (lazyParser, true);
+    AJson->SetLazyNumber(lazyParser, true);
+
+    JsonValue* lazy = AJson->ParseWith(lazyParser, "[9007199254740993, 1.0]");
+
+    Test_Check(AJson->GetHash(lazy) == AJson->GetHash(a));
+    Test_Check(AJson->GetHash(lazy) != AJson->GetHash(b));
+    Test_Check(AJson->Equals(lazy, a) == true);
+
+    AJson->DestroyParser(lazyParser);
+    AJson->Destroy(c);
+    AJson->DestroyParser(parser);
+}
+
+
+static void TestDedupKeyPool(void)
+{
+    const char*  json   = "[{\"id\": 1, \"tag\": {\"name\": \"the long name of tag\"}},"
+                          " {\"id\": 2, \"tag\": {\"name\": \"the long name of tag\"}},"
+                          " {\"id\": 1, \"tag\": {\"name\": \"the long name of tag\"}}]";
+    JsonParser*  parser = AJson->CreateParser(NULL);
+    JsonKeyPool* pool   = AJsonKeyPool->Create();
+    JsonDedupStats stats;
+
+    AJson->SetDedup  (parser, true);
+    AJson->SetKeyPool(parser, pool);
+
+    JsonValue* value = AJson->ParseWith(parser, json);
+    JsonArray* array = value->jsonArray;
+
+    AJson->GetDedupStats(parser, &stats);
+
+    Test_Check(stats.dedupCount > 0 && stats.savedBytes > 0);
+    Test_Check(AJsonArray->GetObject(array, 0) == AJsonArray->GetObject(array, 2));
+    Test_Check(AJsonArray->GetObject(array, 0) != AJsonArray->GetObject(array, 1));
+
+    const JsonKey* id = AJsonKeyPool->Intern(pool, "id", 2);
+
+    Test_Check(id != NULL && id == AJsonKeyPool->Intern(pool, "idx", 2));
+    Test_Check(AJsonKeyPool->GetCount(pool) == 3);
+    Test_Check(AJsonObject->GetValue(AJsonArray->GetObject(array, 1), id)->jsonFloat == 2.0f);
+
+    // the too long key not stored in pool, but in parser
+    char longJson[JsonKeyPool_MaxKeyLength + 16];
+
+    memset(longJson, 'k', sizeof(longJson));
+    memcpy(longJson, "{\"", 2);
+    memcpy(longJson + JsonKeyPool_MaxKeyLength + 3, "\": 5}", 6);
+    longJson[JsonKeyPool_MaxKeyLength + 9] = '\0';
+
+    Test_Check(AJsonKeyPool->Intern(pool, longJson + 2, JsonKeyPool_MaxKeyLength + 1) == NULL);
+    value = AJson->ParseWith(parser, longJson);
+    Test_Check(value != NULL);
+    Test_Check(strlen(AJsonObject->GetKey(value->jsonObject, 0)) == JsonKeyPool_MaxKeyLength + 1);
+    Test_Check(AJsonKeyPool->GetCount(pool) == 3);
+
+    AJson->DestroyParser(parser);
+    AJsonKeyPool->Destroy(pool);
+
+    // the lazy number cached by get still equals the same raw text
+    const char* lazyJson = "[[1.5, \"x\"]]";
+
+    parser = AJson->CreateParser(NULL);
+    AJson->SetDedup     (parser, true);
+    AJson->SetLazyNumber(parser, true);
+
+    JsonArray* lazy = AJsonArray->GetArray(AJson->ParseWith(parser, lazyJson)->jsonArray, 0);
+
+    Test_Check(AJsonArray->GetFloat(lazy, 0) == 1.5f);
+    Test_Check(AJsonArray->GetArray(AJson->ParseWith(parser, lazyJson)->jsonArray, 0) == lazy);
+
+    AJson->DestroyParser(parser);
+}
+
+
+#ifdef JSON_TRACE
+static void OnTrace(void* context, const char* message)
+{
+    (void) message;
+    ++*(int*) context;
+}
+#endif
+
+
+static void TestStatsLimits(void)
+{
+    const char*     json   = "{\"a\": [1, 2, 3], \"b\": [true, null, \"x\"], \"c\": {\"d\": [[]]}}";
+    JsonParser*     parser = AJson->CreateParser(NULL);
+    JsonParseLimits limits = {0};
+    JsonParseStats  stats;
+
+#ifdef JSON_TRACE
+    int traceCount = 0;
+    AJson->SetTrace(OnTrace, &traceCount);
+#endif
+
+    AJson->SetParseTiming(parser, true);
+    Test_Check(AJson->ParseWith(parser, json) != NULL);
+    AJson->GetParseStats(parser, &stats);
+
+    Test_Check(stats.error == JsonParseError_None && stats.bytes == strlen(json));
+    Test_Check(stats.objectCount == 2 && stats.arrayCount == 4 && stats.keyCount == 4);
+    Test_Check(stats.numberCount == 3 && stats.stringCount == 1 && stats.literalCount == 2);
+    Test_Check(stats.maxDepth == 4 && stats.allocCount > 0 && stats.allocBytes > 0);
+
+    // the Parse without parser counts the malloc of each container
+    JsonParseStats parseStats;
+
+    AJson->Destroy(AJson->ParseAndGetStats(json, &parseStats));
+    Test_Check(parseStats.error == JsonParseError_None && parseStats.maxDepth == 4);
+    Test_Check(parseStats.allocCount >= stats.objectCount + stats.arrayCount);
+
+    Test_Check(AJson->ParseAndGetStats("[1, ", &parseStats) == NULL);
+    Test_Check(parseStats.error == JsonParseError_Syntax);
+
+#ifdef JSON_TRACE
+    Test_Check(traceCount > 0);
+    AJson->SetTrace(NULL, NULL);
+#endif
+
+    // the invalid json fails without assert
+    Test_Check(AJson->ParseWith(parser, "[1, 2 3]") == NULL);
+    AJson->GetParseStats(parser, &stats);
+    Test_Check(stats.error == JsonParseError_Syntax);
+    Test_Check(AJson->ParseWith(parser, "{\"a\" 1}") == NULL);
+    Test_Check(AJson->ParseWith(parser, "{\"a\": [1, {\"b\": 2}") == NULL);
+
+    // the unterminated strings stop at '\0', also after a backslash
+    const char* incompletes[] = {"{\"a\": \"abc", "[\"x\\", "{\"a\": \"\\u12", "{\"ab"};
+
+    for (int i = 0; i < (int) (sizeof(incompletes) / sizeof(incompletes[0])); ++i)
+    {
+        Test_Check(AJson->ParseWith(parser, incompletes[i]) == NULL);
+        AJson->GetParseStats(parser, &stats);
+        Test_Check(stats.error == JsonParseError_Syntax);
+    }
+
+    limits.maxDepth = 3;
+    AJson->SetLimits(parser, &limits);
+    Test_Check(AJson->ParseWith(parser, json) == NULL);
+    AJson->GetParseStats(parser, &stats);
+    Test_Check(stats.error == JsonParseError_MaxDepth);
+
+    limits.maxDepth = 0;
+    limits.maxBytes = 16;
+    AJson->SetLimits(parser, &limits);
+    Test_Check(AJson->ParseWith(parser, json) == NULL);
+    AJson->GetParseStats(parser, &stats);
+    Test_Check(stats.error == JsonParseError_MaxBytes);
+    Test_Check(AJson->ParseWith(parser, "[1, 2]") != NULL);
+
+    // the arena retained by Reset is not allocated again, so the new parser for alloc limit
+    AJson->DestroyParser(parser);
+    parser               = AJson->CreateParser(NULL);
+    limits.maxBytes      = 0;
+    limits.maxAllocBytes = 64;
+    AJson->SetLimits(parser, &limits);
+    Test_Check(AJson->ParseWith(parser, json) == NULL);
+    AJson->GetParseStats(parser, &stats);
+    Test_Check(stats.error == JsonParseError_MaxAlloc);
+
+    AJson->SetLimits(parser, NULL);
+    Test_Check(AJson->ParseWith(parser, json) != NULL);
+
+    AJson->DestroyParser(parser);
+}
+
+
+static void TestDestroyDeferred(void)
+{
+    AJson->DestroyDeferred(AJson->Parse("{\"a\": [1, \"the string longer than 14\", {\"b\": [[], {}]}]}"));
+    AJson->DestroyDeferred(AJson->Parse("[]"));
+
+    Test_Check(AJson->ReclaimDeferred() == 2);
+    Test_Check(AJson->ReclaimDeferred() == 0);
+
+    // the default depth stops the deep nesting before the recursion overflows the stack
+    int   depth = 100000;
+    char* deep  = malloc((size_t) depth * 2 + 1);
+
+    memset(deep,         '[', (size_t) depth);
+    memset(deep + depth, ']', (size_t) depth);
+    deep[depth * 2] = '\0';
+
+    Test_Check(AJson->Parse(deep) == NULL);
+
+    JsonParser*    parser = AJson->CreateParser(NULL);
+    JsonParseStats stats;
+
+    Test_Check(AJson->ParseWith(parser, deep) == NULL);
+    AJson->GetParseStats(parser, &stats);
+    Test_Check(stats.error == JsonParseError_MaxDepth);
+    AJson->DestroyParser(parser);
+
+    // the tree at default depth is destroyed by loop
+    depth = JsonParseLimits_DefaultMaxDepth;
+    memset(deep + depth, ']', (size_t) depth);
+    deep[depth * 2] = '\0';
+
+    JsonValue* value = AJson->Parse(deep);
+
+    Test_Check(value != NULL);
+    AJson->Destroy(value);
+
+    value = AJson->Parse(deep);
+    Test_Check(value != NULL);
+    AJson->DestroyDeferred(value);
+    Test_Check(AJson->ReclaimDeferred() == 1);
+
+    free(deep);
+}
+
+
+static void TestDoc(void)
+{
+    JsonDoc*     doc  = AJsonDoc->Create(AJson->Parse("{\"v\": 1}"));
+    JsonDocSlot* slot = AJsonDoc->CreateSlot(doc);
+    JsonDoc*     current = AJsonDoc->Acquire(slot);
+
+    AJsonDoc->Publish(slot, AJsonDoc->Create(AJson->Parse("{\"v\": 2}")));
+
+    // the old doc alive until released
+    Test_Check(AJsonObject->GetInt(AJsonDoc->GetRoot(current)->jsonObject, "v", 0) == 1);
+    AJsonDoc->Release(current);
+
+    current = AJsonDoc->Acquire(slot);
+    Test_Check(AJsonObject->GetInt(AJsonDoc->GetRoot(current)->jsonObject, "v", 0) == 2);
+    AJsonDoc->Release(current);
+
+    AJsonDoc->DestroySlot(slot);
+}
+
+
+static void TestCache(void)
+{
+    JsonCache*     cache = AJsonCache->Create(4096);
+    JsonCacheStats stats;
+
+    JsonDoc* a = AJsonCache->Parse(cache, "{\"state\": [1, 2, 3], \"name\": \"the string longer than 14\"}");
+    JsonDoc* b = AJsonCache->Parse(cache, "{\"state\": [1, 2, 3], \"name\": \"the string longer than 14\"}");
+    JsonDoc* c = AJsonCache->Parse(cache, "{\"state\": [1, 2, 4]}");
+
+    Test_Check(a != NULL && a == b && c != NULL && c != a);
+    Test_Check(AJsonCache->Parse(cache, "[1, ") == NULL);
+
+    AJsonCache->GetStats(cache, &stats);
+    Test_Check(stats.hitCount == 1 && stats.missCount == 3 && stats.docCount == 2 && stats.usedBytes <= 4096);
+
+    // the json larger than budget not cached, and the cached docs evicted by budget
+    char json[4096];
+    memset(json, ' ', sizeof(json) - 3);
+    memcpy(json + sizeof(json) - 3, "[]", 3);
+    JsonDoc* large = AJsonCache->Parse(cache, json);
+
+    for (int i = 0; i < 64; ++i)
+    {
+        sprintf(json, "[%d, \"the string longer than 14\"]", i);
+        AJsonDoc->Release(AJsonCache->Parse(cache, json));
+    }
+
+    AJsonCache->GetStats(cache, &stats);
+    Test_Check(large != NULL && stats.evictCount > 0 && stats.usedBytes <= 4096);
+
+    // the evicted doc still valid for holder
+    JsonObject* object = AJsonDoc->GetRoot(a)->jsonObject;
+    Test_Check(strcmp(AJsonObject->GetString(object, "name", ""), "the string longer than 14") == 0);
+    Test_Check(AJsonArray->GetCount(AJsonObject->GetArray(object, "state")) == 3);
+
+    AJsonDoc->Release(a);
+    AJsonDoc->Release(b);
+    AJsonDoc->Release(c);
+    AJsonDoc->Release(large);
+    AJsonCache->Destroy(cache);
+}
+
+
+static void TestColumn(void)
+{
+    const char* json = "[{\"id\": 1, \"name\": \"a\"}, {\"id\": 2, \"name\": \"bb\"}, {\"name\": \"c\"}]";
+    int64_t     ids    [4];
+    int         offsets[4];
+    int         lengths[4];
+    uint8_t     nulls  [2][1] = {{0}};
+    char        stringData[16];
+    JsonColumn  columns[2] =
+    {
+        {"id",   JsonColumnType_Int64,  ids,     NULL,    nulls[0], NULL,       0,  0},
+        {"name", JsonColumnType_String, offsets, lengths, nulls[1], stringData, 16, 0},
+    };
+
+    Test_Check(AJsonColumn->FromJson(json, columns, 2, 4) == 3);
+    Test_Check(ids[0] == 1 && ids[1] == 2 && nulls[0][0] == 0x04);
+    Test_Check(lengths[1] == 2 && memcmp(stringData + offsets[1], "bb", 2) == 0);
+
+    JsonValue* value = AJson->Parse(json);
+
+    memset(ids, 0, sizeof(ids));
+    Test_Check(AJsonColumn->FromArray(value->jsonArray, columns, 2, 2) == 2);
+    Test_Check(ids[0] == 1 && ids[1] == 2 && lengths[1] == 2 && memcmp(stringData + offsets[1], "bb", 2) == 0);
+
+    AJson->Destroy(value);
+
+    // the lazy number keeps the exact ids that float cannot hold
+    const char* idJson = "[{\"id\": 123456789}, {\"id\": 9007199254740993}, {\"id\": -7}]";
+    JsonParser* parser = AJson->CreateParser(NULL);
+
+    AJson->SetLazyNumber(parser, true);
+    value = AJson->ParseWith(parser, idJson);
+
+    Test_Check(AJsonColumn->FromArray(value->jsonArray, columns, 1, 4) == 3);
+    Test_Check(ids[0] == 123456789 && ids[1] == 9007199254740993LL && ids[2] == -7);
+
+    Test_Check(AJsonColumn->FromJson(idJson, columns, 1, 4) == 3);
+    Test_Check(ids[0] == 123456789 && ids[1] == 9007199254740993LL && ids[2] == -7);
+
+    // the not integral or out of range number is null in Int64 column, and json null is not "null" string
+    const char* nullJson = "[{\"id\": 1.5, \"name\": null}, {\"id\": 1e300}, {\"id\": 2.0}]";
+
+    value = AJson->ParseWith(parser, nullJson);
+
+    Test_Check(AJsonColumn->FromArray(value->jsonArray, columns, 2, 4) == 3);
+    Test_Check(nulls[0][0] == 0x03 && ids[2] == 2 && nulls[1][0] == 0x07);
+
+    Test_Check(AJsonColumn->FromJson(nullJson, columns, 2, 4) == 3);
+    Test_Check(nulls[0][0] == 0x03 && ids[2] == 2 && nulls[1][0] == 0x07);
+
+    AJson->DestroyParser(parser);
+
+    // the not array and incomplete json stop without reading past the end
+    Test_Check(AJsonColumn->FromJson("{\"id\": 1}",  columns, 1, 4) == -1);
+    Test_Check(AJsonColumn->FromJson("[{\"id\": 1",  columns, 1, 4) == -1);
+    Test_Check(AJsonColumn->FromJson("[{\"id\"",     columns, 1, 4) == -1);
+    Test_Check(AJsonColumn->FromJson("[{\"id\": 1,", columns, 1, 4) == -1);
+    Test_Check(AJsonColumn->FromJson("[{\"id\": 1}", columns, 1, 4) == -1);
+    Test_Check(AJsonColumn->FromJson("[]",           columns, 0, 4) ==  0);
+}
+
+
+static void TestIndex(void)
+{
+    const char* json   = "{\"id\": 7, \"a\": [1, {\"b\": \"}\"}]}\n{\"id\": \"k\"}\n12.5";
+    size_t      length = strlen(json);
+    JsonIndex*  index  = AJsonIndex->Build(json, length, "id");
+
+    Test_Check(index != NULL && AJsonIndex->GetCount(index) == 3);
+    Test_Check(AJsonIndex->FindKey(index, json, length, "k", 1) ==  1);
+    Test_Check(AJsonIndex->FindKey(index, json, length, "z", 1) == -1);
+
+    JsonValue* value = AJsonIndex->ParseRecord(index, json, length, 0);
+
+    Test_Check(AJsonObject->GetInt(value->jsonObject, "id", 0) == 7);
+    AJson->Destroy(value);
+
+    Test_Check(AJsonIndex->Save(index, "JsonTest.idx"));
+    AJsonIndex->Destroy(index);
+
+    index = AJsonIndex->Load("JsonTest.idx");
+
+    Test_Check(index != NULL && AJsonIndex->IsSource(index, json, length));
+    Test_Check(AJsonIndex->FindKey(index, json, length, "7", 1) == 0);
+
+    // the shorter json is not the source, and the records beyond it are rejected
+    Test_Check(AJsonIndex->IsSource(index, json, 20) == false);
+    Test_Check(AJsonIndex->IsSource(index, "[1]",  3) == false);
+    Test_Check(AJsonIndex->FindKey    (index, json, 10, "k", 1) == -1);
+    Test_Check(AJsonIndex->ParseRecord(index, json, 20, 1)      == NULL);
+    Test_Check(AJsonIndex->ParseRecord(index, json, 10, 0)      == NULL);
+
+    AJsonIndex->Destroy(index);
+    remove("JsonTest.idx");
+
+    Test_Check(AJsonIndex->Build("[{\"id\": ", 8, "id") == NULL);
+}
+
+
+static char   formatOutput[256];
+static size_t formatLength;
+
+
+static void OnFormatWrite(void* context, const char* data, size_t length)
+{
+    (void) context;
+
+    memcpy(formatOutput + formatLength, data, length);
+    formatLength += length;
+}
+
+
+/**
+ * Format json by chunks of chunkSize, return whether the json complete.
+ */
+static bool Format(int indent, const char* json, size_t chunkSize)
+{
+    JsonFormat* format = AJsonFormat->Create(indent, OnFormatWrite, NULL);
+    size_t      length = strlen(json);
+
+    formatLength = 0;
+
+    for (size_t i = 0; i < length; i += chunkSize)
+    {
+        AJsonFormat->Write(format, json + i, length - i < chunkSize ? length - i : chunkSize);
+    }
+
+    bool isComplete = AJsonFormat->Finish(format);
+
+    formatOutput[formatLength] = '\0';
+    AJsonFormat->Destroy(format);
+
+    return isComplete;
+}
+
+
+static void TestFormat(void)
+{
+    const char* json     = " { \"a\" : [ 1 , true , \"x \\\" y\" , [ ] ] ,\n\t\"b\" : { \"c\" : -0.5 } } ";
+    const char* minified = "{\"a\":[1,true,\"x \\\" y\",[]],\"b\":{\"c\":-0.5}}";
+    const char* indented = "{\n  \"a\": [\n    1,\n    true,\n    \"x \\\" y\",\n    []\n  ],\n"
+                           "  \"b\": {\n    \"c\": -0.5\n  }\n}";
+
+    for (size_t chunkSize = 1; chunkSize < 64; chunkSize += 7)
+    {
+        Test_Check(Format(0, json, chunkSize) && strcmp(formatOutput, minified) == 0);
+        Test_Check(Format(2, json, chunkSize) && strcmp(formatOutput, indented) == 0);
+    }
+
+    Test_Check(Format(0, "{\"a\":1} 2", 3) && strcmp(formatOutput, "{\"a\":1}\n2") == 0);
+    Test_Check(Format(0, "{\"a\":[1}",  3) == false);
+    Test_Check(Format(0, "\"abc",       3) == false);
+}
+
+
+static void TestPack(void)
+{
+    const char* json   = "{\"id\":123,\"neg\":-5,\"f\":0.1,\"s\":\"q\\\"\\u00e9\",\"a\":[[],{},[1,[2]]],\"t\":true,\"n\":null}";
+    const char* output = "{\"id\":123,\"neg\":-5,\"f\":0.1,\"s\":\"q\\\"\xc3\xa9\",\"a\":[[],{},[1,[2]]],\"t\":true,\"n\":null}";
+    char        data[128];
+    char        text[128];
+
+    for (int packFormat = JsonPackFormat_MessagePack; packFormat <= JsonPackFormat_CBOR; ++packFormat)
+    {
+        size_t length = AJsonPack->FromJson(packFormat, json, strlen(json), data, sizeof(data));
+
+        Test_Check(length > 0 && length <= sizeof(data));
+        Test_Check(AJsonPack->ToJson(packFormat, data, length, text, sizeof(text)) == strlen(output));
+        Test_Check(strcmp(text, output) == 0);
+
+        // too small buffer returns the capacity to retry
+        Test_Check(AJsonPack->FromJson(packFormat, json, strlen(json), data, 8) > 8);
+        Test_Check(AJsonPack->FromJson(packFormat, "[1,]", 4, data, sizeof(data)) == 0);
+    }
+
+    size_t length = AJsonPack->FromJson(JsonPackFormat_MessagePack, "[true,false,null]", 17, data, sizeof(data));
+
+    Test_Check(length == 4 && memcmp(data, "\x93\xc3\xc2\xc0", 4) == 0);
+}
+
+
+static void OnFilterRecord(void* context, const char* record, size_t length, JsonValue* value)
+{
+    (void) record;
+    (void) length;
+
+    if (value != NULL)
+    {
+        *(float*) context += AJsonObject->GetFloat(value->jsonObject, "code", 0.0f);
+    }
+}
+
+
+static void TestFilter(void)
+{
+    const char* json   = "{\"level\": \"info\", \"code\": 200, \"user\": {\"name\": \"a\"}}\r\n"
+                         "\n{\"level\": \"error\", \"code\": 503, \"user\": {\"name\": \"bot\"}}\n"
+                         "{\"code\": 500, \"level\": \"error\", \"user\": {\"admin\": true}}\n"
+                         "[1, 2]\n{\"level\": \"error\", \"code\": \"500\"}";
+    JsonFilter* filter = AJsonFilter->Create("level == \"error\" && (code >= 500 || user.name != \"bot\")");
+    JsonParser* parser = AJson->CreateParser(NULL);
+    float       sum    = 0.0f;
+
+    Test_Check(filter != NULL);
+    Test_Check(AJsonFilter->Run(filter, json, strlen(json), parser, OnFilterRecord, &sum) == 2 && sum == 1003.0f);
+
+    // the result decided before the incomplete rest
+    const char* record = "{\"level\": \"error\", \"code\": 1e3, \"rest\": [";
+    Test_Check(AJsonFilter->Match(filter, record, strlen(record)));
+    record = "{\"level\": \"debug\"}";
+    Test_Check(AJsonFilter->Match(filter, record, strlen(record)) == false);
+
+    // the matched but truncated last record of json not end with '\0' is passed without value
+    const char* lines  = "{\"level\": \"error\", \"code\": 501}\n{\"level\": \"error\", \"code\": 502, \"msg\": \"abc";
+    size_t      length = strlen(lines);
+    char*       buffer = malloc(length);
+
+    memcpy(buffer, lines, length);
+    sum = 0.0f;
+
+    Test_Check(AJsonFilter->Run(filter, buffer, length, parser, OnFilterRecord, &sum) == 2 && sum == 501.0f);
+
+    free(buffer);
+    AJsonFilter->Destroy(filter);
+
+    filter = AJsonFilter->Create("\"a.b\".c < -100 || level == null");
+    record = "{\"a.b\": {\"c\": -1.5e2}}";
+    Test_Check(filter != NULL && AJsonFilter->Match(filter, record, strlen(record)));
+    Test_Check(AJsonFilter->Run(filter, json, strlen(json), NULL, OnFilterRecord, &sum) == 0);
+    AJsonFilter->Destroy(filter);
+
+    Test_Check(AJsonFilter->Create("level ==")   == NULL);
+    Test_Check(AJsonFilter->Create("(a == 1")    == NULL);
+    Test_Check(AJsonFilter->Create("a == 1 b")   == NULL);
+
+    AJson->DestroyParser(parser);
+}
+
+
+int main(void)
+{
+    TestParse();
+    TestPackedArray();
+    TestParser();
+    TestHashDiff();
+    TestDedupKeyPool();
+    TestStatsLimits();
+    TestDestroyDeferred();
+    TestDoc();
+    TestCache();
+    TestColumn();
+    TestIndex();
+    TestFormat();
+    TestPack();
+    TestFilter();
+
+    printf("JsonTest: %d checks, %d failed\n", checkCount, failCount);
+
+    return failCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
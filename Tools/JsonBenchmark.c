@@ -0,0 +1,813 @@
+/*
+ * Copyright (c) scott.cgi All Rights Reserved.
+ *
+ * This source code belongs to project MojoJson, which is hosted on GitHub, and licensed under the MIT License.
+ *
+ * License: https://github.com/scottcgi/MojoJson/blob/master/LICENSE
+ * GitHub : https://github.com/scottcgi/MojoJson
+ *
+ * Since  : 2026-10-18
+ * Author : scott.cgi
+ * Version: 1.3.0
+ */
+
+
+/**
+ * The benchmark of Json.c over the generated corpora, the same seed generates the same json on any machine.
+ *
+ * usage: JsonBenchmark [--quick] [--seconds <min seconds>] [--iterations <count>] [--output <result.json>]
+ *
+ * the corpora are twitter, canada and citm style documents, and the stress shapes of deep nesting,
+ * huge object, long strings and number-heavy array. each corpus runs the workloads:
+ *
+ * parse    : AJson->Parse and AJson->Destroy.
+ * parseWith: AJson->ParseWith and AJson->Reset of reused parser.
+ * access   : the accessor-heavy walk of parsed document by AJsonObject and AJsonArray.
+ *
+ * and reports MB/s, ns per value, allocations per document and peak RSS,
+ * the allocations of parse are the malloc and realloc counted by AJson->ParseAndGetStats,
+ * and the allocations of parseWith are the calls into the counting JsonAllocator of reused parser.
+ * the --output writes all results in json for comparison across versions.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/resource.h>
+#endif
+
+#include "../Json.h"
+
+
+// Text builder
+//----------------------------------------------------------------------------------------------------------------------
+
+
+typedef struct
+{
+    char*  data;
+    size_t length;
+    size_t capacity;
+
+    /**
+     * The count of json values written, for ns per value.
+     */
+    long   valueCount;
+}
+Text;
+
+
+static void TextAppend(Text* text, const char* format, ...)
+{
+    while (true)
+    {
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(text->data + text->length, text->capacity - text->length, format, args);
+        va_end(args);
+
+        if ((size_t) length < text->capacity - text->length)
+        {
+            text->length += (size_t) length;
+            return;
+        }
+
+        text->capacity = text->capacity * 2 + (size_t) length;
+        text->data     = realloc(text->data, text->capacity);
+
+        if (text->data == NULL)
+        {
+            fprintf(stderr, "JsonBenchmark: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+
+/**
+ * The xorshift random that same on all machines.
+ */
+static unsigned int randomState;
+
+
+static unsigned int Random(unsigned int range)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return randomState % range;
+}
+
+
+static const char* const words[] =
+{
+    "json", "parser", "fast", "simple", "value", "array", "object", "string", "number", "stream",
+    "\\u3053\\u3093\\u306b\\u3061\\u306f", "caf\\u00e9", "line\\nbreak", "quote\\\"d", "tab\\t",
+};
+
+
+static void AppendWords(Text* text, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        TextAppend(text, i == 0 ? "%s" : " %s", words[Random(sizeof(words) / sizeof(words[0]))]);
+    }
+}
+
+
+// Corpora
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * The search result of statuses with nested user and entities.
+ */
+static void GenerateTwitter(Text* text, int scale)
+{
+    int count = 100 * scale;
+
+    TextAppend(text, "{\"statuses\": [");
+
+    for (int i = 0; i < count; ++i)
+    {
+        TextAppend
+        (
+            text,
+            "%s\n  {\"id\": %u%06u, \"id_str\": \"%u%06u\", \"text\": \"",
+            i == 0 ? "" : ",", 50000 + i, Random(1000000), 50000 + i, Random(1000000)
+        );
+        AppendWords(text, 12);
+        TextAppend
+        (
+            text,
+            "\", \"truncated\": false, \"retweet_count\": %u, \"favorite_count\": %u, \"lang\": \"ja\","
+            " \"user\": {\"id\": %u, \"name\": \"user%u\", \"screen_name\": \"screen_%u\", \"description\": \"",
+            Random(1000), Random(1000), Random(100000000), i, i
+        );
+        AppendWords(text, 8);
+        TextAppend
+        (
+            text,
+            "\", \"followers_count\": %u, \"friends_count\": %u, \"verified\": %s, \"profile_image_url\":"
+            " \"http://example.com/images/%u/normal.png\", \"default_profile\": true},"
+            " \"entities\": {\"hashtags\": [{\"text\": \"tag%u\", \"indices\": [%u, %u]}], \"urls\": [],"
+            " \"user_mentions\": []}, \"in_reply_to_status_id\": null, \"geo\": null}",
+            Random(100000), Random(1000), Random(2) ? "true" : "false", Random(1000000), i, Random(50), Random(50) + 50
+        );
+
+        text->valueCount += 25;
+    }
+
+    TextAppend
+    (
+        text,
+        "\n], \"search_metadata\": {\"completed_in\": 0.087, \"max_id\": 505874924095815681, \"count\": %d}}",
+        count
+    );
+
+    text->valueCount += 6;
+}
+
+
+/**
+ * The GeoJSON polygon of many coordinate pairs.
+ */
+static void GenerateCanada(Text* text, int scale)
+{
+    int rings = 4 * scale;
+
+    TextAppend
+    (
+        text,
+        "{\"type\": \"FeatureCollection\", \"features\": [{\"type\": \"Feature\", \"properties\": {\"name\": \"Canada\"},"
+        " \"geometry\": {\"type\": \"Polygon\", \"coordinates\": ["
+    );
+
+    for (int i = 0; i < rings; ++i)
+    {
+        int points = 500 + (int) Random(1000);
+
+        TextAppend(text, i == 0 ? "[" : ",\n[");
+
+        for (int j = 0; j < points; ++j)
+        {
+            TextAppend
+            (
+                text,
+                j == 0 ? "[-%u.%09u,%u.%09u]" : ",[-%u.%09u,%u.%09u]",
+                50 + Random(90), Random(1000000000), 40 + Random(40), Random(1000000000)
+            );
+        }
+
+        TextAppend(text, "]");
+        text->valueCount += 1 + points * 3;
+    }
+
+    TextAppend(text, "]}}]}");
+    text->valueCount += 10;
+}
+
+
+/**
+ * The events and performances with numeric id keys and nested arrays.
+ */
+static void GenerateCitm(Text* text, int scale)
+{
+    int count = 50 * scale;
+
+    TextAppend(text, "{\"areaNames\": {");
+
+    for (int i = 0; i < count; ++i)
+    {
+        TextAppend(text, "%s\"%u\": \"", i == 0 ? "" : ", ", 205705993 + i);
+        AppendWords(text, 2);
+        TextAppend(text, "\"");
+    }
+
+    TextAppend(text, "}, \"events\": {");
+
+    for (int i = 0; i < count; ++i)
+    {
+        TextAppend
+        (
+            text,
+            "%s\n\"%u\": {\"description\": null, \"id\": %u, \"logo\": null, \"name\": \"event %u\","
+            " \"subTopicIds\": [337184269, 337184283], \"subjectCode\": null, \"subtitle\": null,"
+            " \"topicIds\": [324846099, %u]}",
+            i == 0 ? "" : ",", 1385863 + i, 1385863 + i, i, 107888604 + Random(100)
+        );
+    }
+
+    TextAppend(text, "}, \"performances\": [");
+
+    for (int i = 0; i < count * 4; ++i)
+    {
+        TextAppend
+        (
+            text,
+            "%s\n{\"eventId\": %u, \"id\": %u, \"logo\": \"/images/UE0AAAAACEKo6QAAAAVDSVRN\", \"name\": null,"
+            " \"prices\": [{\"amount\": %u, \"audienceSubCategoryId\": 337100890, \"seatCategoryId\": 338937295},"
+            " {\"amount\": %u, \"audienceSubCategoryId\": 337100890, \"seatCategoryId\": 338937296}],"
+            " \"seatCategories\": [{\"areas\": [{\"areaId\": 205705999, \"blockIds\": []},"
+            " {\"areaId\": 205705998, \"blockIds\": []}], \"seatCategoryId\": 338937295}],"
+            " \"seatMapImage\": null, \"start\": %u000, \"venueCode\": \"PLEYEL_PLEYEL\"}",
+            i == 0 ? "" : ",", 1385863 + Random((unsigned int) count), 339887544 + i, 10000 + Random(90000),
+            10000 + Random(90000), 1372701600 + Random(10000000)
+        );
+
+        text->valueCount += 32;
+    }
+
+    TextAppend(text, "]}");
+    text->valueCount += 3 + count * 13;
+}
+
+
+/**
+ * The nesting of arrays and objects, each level adds 2 depth and kept in the default max depth of AJson->Parse.
+ */
+static void GenerateDeep(Text* text, int scale)
+{
+    int depth = 100 + 50 * scale;
+
+    if (depth > JsonParseLimits_DefaultMaxDepth / 2)
+    {
+        depth = JsonParseLimits_DefaultMaxDepth / 2;
+    }
+
+    for (int i = 0; i < depth; ++i)
+    {
+        TextAppend(text, "[{\"k\": %d, \"v\": ", i);
+    }
+
+    TextAppend(text, "0");
+
+    for (int i = 0; i < depth; ++i)
+    {
+        TextAppend(text, "}]");
+    }
+
+    text->valueCount += depth * 3 + 1;
+}
+
+
+static void GenerateHugeObject(Text* text, int scale)
+{
+    int count = 2000 * scale;
+
+    TextAppend(text, "{");
+
+    for (int i = 0; i < count; ++i)
+    {
+        TextAppend(text, "%s\"key_%d\": %d", i == 0 ? "" : ", ", i, i);
+    }
+
+    TextAppend(text, "}");
+    text->valueCount += count + 1;
+}
+
+
+static void GenerateLongStrings(Text* text, int scale)
+{
+    int count = 4 + scale / 4;
+
+    TextAppend(text, "[");
+
+    for (int i = 0; i < count; ++i)
+    {
+        TextAppend(text, i == 0 ? "\"" : ", \"");
+        AppendWords(text, 8000);
+        TextAppend(text, "\"");
+    }
+
+    TextAppend(text, "]");
+    text->valueCount += count + 1;
+}
+
+
+static void GenerateNumbers(Text* text, int scale)
+{
+    int count = 10000 * scale;
+
+    TextAppend(text, "[");
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            TextAppend(text, i == 0 ? "%u" : ",%u", Random(100000000));
+        }
+        else
+        {
+            TextAppend(text, ",%s%u.%ue%d", Random(2) ? "-" : "", Random(10), Random(1000000), (int) Random(40) - 20);
+        }
+    }
+
+    TextAppend(text, "]");
+    text->valueCount += count + 1;
+}
+
+
+// Accessor workloads
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/**
+ * Prevent the compiler from removing the access.
+ */
+static volatile double accessSink;
+
+
+static void AccessTwitter(JsonValue* root)
+{
+    JsonArray* statuses = AJsonObject->GetArray(root->jsonObject, "statuses");
+    double     sum      = 0.0;
+
+    for (int i = 0, count = AJsonArray->GetCount(statuses); i < count; ++i)
+    {
+        JsonObject* status = AJsonArray->GetObject(statuses, i);
+        JsonObject* user   = AJsonObject->GetObject(status, "user");
+
+        sum += AJsonObject->GetInt   (status, "retweet_count",   0);
+        sum += AJsonObject->GetBool  (user,   "verified",        false);
+        sum += AJsonObject->GetFloat (user,   "followers_count", 0.0f);
+        sum += strlen(AJsonObject->GetString(status, "text", ""));
+        sum += strlen(AJsonObject->GetString(user,   "screen_name", ""));
+
+        JsonArray* hashtags = AJsonObject->GetArray(AJsonObject->GetObject(status, "entities"), "hashtags");
+        sum += AJsonArray->GetInt(AJsonObject->GetArray(AJsonArray->GetObject(hashtags, 0), "indices"), 1);
+    }
+
+    accessSink = sum;
+}
+
+
+static void AccessCanada(JsonValue* root)
+{
+    JsonObject* feature  = AJsonArray->GetObject(AJsonObject->GetArray(root->jsonObject, "features"), 0);
+    JsonArray*  rings    = AJsonObject->GetArray(AJsonObject->GetObject(feature, "geometry"), "coordinates");
+    double      sum      = 0.0;
+
+    for (int i = 0, count = AJsonArray->GetCount(rings); i < count; ++i)
+    {
+        JsonArray* ring = AJsonArray->GetArray(rings, i);
+
+        for (int j = 0, points = AJsonArray->GetCount(ring); j < points; ++j)
+        {
+            double point[2];
+            AJsonArray->CopyDoubles(AJsonArray->GetArray(ring, j), 0, 2, point);
+            sum += point[0] + point[1];
+        }
+    }
+
+    accessSink = sum;
+}
+
+
+static void AccessCitm(JsonValue* root)
+{
+    JsonArray*  performances = AJsonObject->GetArray (root->jsonObject, "performances");
+    JsonObject* events       = AJsonObject->GetObject(root->jsonObject, "events");
+    double      sum          = 0.0;
+
+    for (int i = 0, count = AJsonArray->GetCount(performances); i < count; ++i)
+    {
+        JsonObject* performance = AJsonArray->GetObject(performances, i);
+        JsonArray*  prices      = AJsonObject->GetArray(performance, "prices");
+        char        eventId[16];
+
+        for (int j = 0, priceCount = AJsonArray->GetCount(prices); j < priceCount; ++j)
+        {
+            sum += AJsonObject->GetFloat(AJsonArray->GetObject(prices, j), "amount", 0.0f);
+        }
+
+        snprintf(eventId, sizeof(eventId), "%d", AJsonObject->GetInt(performance, "eventId", 0));
+        sum += AJsonObject->GetInt(AJsonObject->GetObject(events, eventId), "id", 0);
+        sum += strlen(AJsonObject->GetString(performance, "venueCode", ""));
+    }
+
+    accessSink = sum;
+}
+
+
+static void AccessDeep(JsonValue* root)
+{
+    JsonArray* array = root->jsonArray;
+    double     sum   = 0.0;
+
+    while (array != NULL)
+    {
+        JsonObject* object = AJsonArray->GetObject(array, 0);
+        sum               += AJsonObject->GetInt(object, "k", 0);
+        array              = AJsonObject->GetType(object, "v") == JsonType_Array ?
+                             AJsonObject->GetArray(object, "v") : NULL;
+    }
+
+    accessSink = sum;
+}
+
+
+static void AccessHugeObject(JsonValue* root)
+{
+    char   key[32];
+    double sum = 0.0;
+
+    for (int i = 0; true; i += 7)
+    {
+        snprintf(key, sizeof(key), "key_%d", i);
+
+        // the missing key is the end
+        if (AJsonObject->GetType(root->jsonObject, key) == JsonType_Null)
+        {
+            break;
+        }
+
+        sum += AJsonObject->GetInt(root->jsonObject, key, 0);
+    }
+
+    accessSink = sum;
+}
+
+
+static void AccessLongStrings(JsonValue* root)
+{
+    double sum = 0.0;
+
+    for (int i = 0, count = AJsonArray->GetCount(root->jsonArray); i < count; ++i)
+    {
+        sum += strlen(AJsonArray->GetString(root->jsonArray, i));
+    }
+
+    accessSink = sum;
+}
+
+
+static void AccessNumbers(JsonValue* root)
+{
+    double buffer[256];
+    double sum = 0.0;
+
+    for (int i = 0, count = AJsonArray->GetCount(root->jsonArray); i < count; i += 256)
+    {
+        int copied = AJsonArray->CopyDoubles(root->jsonArray, i, 256, buffer);
+
+        for (int j = 0; j < copied; ++j)
+        {
+            sum += buffer[j];
+        }
+    }
+
+    accessSink = sum;
+}
+
+
+// Benchmark
+//----------------------------------------------------------------------------------------------------------------------
+
+
+typedef struct
+{
+    const char* name;
+    void        (*Generate)(Text* text, int scale);
+    void        (*Access)  (JsonValue* root);
+}
+Corpus;
+
+
+static const Corpus corpora[] =
+{
+    {"twitter",     GenerateTwitter,     AccessTwitter},
+    {"canada",      GenerateCanada,      AccessCanada},
+    {"citm",        GenerateCitm,        AccessCitm},
+    {"deep",        GenerateDeep,        AccessDeep},
+    {"hugeObject",  GenerateHugeObject,  AccessHugeObject},
+    {"longStrings", GenerateLongStrings, AccessLongStrings},
+    {"numbers",     GenerateNumbers,     AccessNumbers},
+};
+
+
+typedef struct
+{
+    const char* corpus;
+    const char* workload;
+    size_t      bytes;
+    long        values;
+    long        iterations;
+    double      seconds;
+    long        allocsPerDoc;
+    long        peakRssKb;
+}
+Result;
+
+
+/**
+ * The JsonAllocator that counts Alloc and Realloc.
+ */
+static long allocCount;
+
+
+static void* CountAlloc(void* context, size_t size)
+{
+    (void) context;
+    ++allocCount;
+    return malloc(size);
+}
+
+
+static void* CountRealloc(void* context, void* ptr, size_t size)
+{
+    (void) context;
+    ++allocCount;
+    return realloc(ptr, size);
+}
+
+
+static void CountFree(void* context, void* ptr)
+{
+    (void) context;
+    free(ptr);
+}
+
+
+static const JsonAllocator countAllocator[1] = {{CountAlloc, CountRealloc, CountFree, NULL}};
+
+
+static double GetSeconds(void)
+{
+    struct timespec time;
+    timespec_get(&time, TIME_UTC);
+
+    return (double) time.tv_sec + (double) time.tv_nsec * 1e-9;
+}
+
+
+/**
+ * The peak resident memory of process in KB, if unsupported return -1.
+ */
+static long GetPeakRssKb(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        #ifdef __APPLE__
+            return (long) (usage.ru_maxrss / 1024);
+        #else
+            return (long) usage.ru_maxrss;
+        #endif
+    }
+#endif
+
+    return -1;
+}
+
+
+typedef enum
+{
+    Workload_Parse,
+    Workload_ParseWith,
+    Workload_Access,
+}
+Workload;
+
+
+static const char* const workloadNames[] = {"parse", "parseWith", "access"};
+
+
+/**
+ * Run workload until minSeconds elapsed, or fixed iterations if greater than 0.
+ */
+static Result RunWorkload(const Corpus* corpus, const Text* text, Workload workload, double minSeconds, long iterations)
+{
+    Result      result[1] = {{corpus->name, workloadNames[workload], text->length, text->valueCount, 0, 0.0, 0, 0}};
+    JsonParser* parser    = AJson->CreateParser(countAllocator);
+    JsonValue*  root      = AJson->Parse(text->data);
+
+    // the allocations of steady document that the parser memory reused
+    AJson->ParseWith(parser, text->data);
+    AJson->Reset(parser);
+    allocCount = 0;
+    AJson->ParseWith(parser, text->data);
+    AJson->Reset(parser);
+
+    switch (workload)
+    {
+        case Workload_Parse:
+        {
+            JsonParseStats stats;
+            AJson->Destroy(AJson->ParseAndGetStats(text->data, &stats));
+            result->allocsPerDoc = stats.allocCount;
+            break;
+        }
+
+        case Workload_ParseWith:
+            result->allocsPerDoc = allocCount;
+            break;
+
+        case Workload_Access:
+            // the access not allocate
+            result->allocsPerDoc = 0;
+            break;
+    }
+
+    double start = GetSeconds();
+
+    do
+    {
+        switch (workload)
+        {
+            case Workload_Parse:
+                AJson->Destroy(AJson->Parse(text->data));
+                break;
+
+            case Workload_ParseWith:
+                AJson->ParseWith(parser, text->data);
+                AJson->Reset(parser);
+                break;
+
+            case Workload_Access:
+                corpus->Access(root);
+                break;
+        }
+
+        ++result->iterations;
+        result->seconds = GetSeconds() - start;
+    }
+    while (iterations > 0 ? result->iterations < iterations : result->seconds < minSeconds);
+
+    AJson->Destroy(root);
+    AJson->DestroyParser(parser);
+
+    result->peakRssKb = GetPeakRssKb();
+
+    return *result;
+}
+
+
+static void WriteResults(const char* filePath, const Result* results, int count, bool isQuick)
+{
+    FILE* file = fopen(filePath, "w");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "JsonBenchmark: unable to write %s\n", filePath);
+        exit(EXIT_FAILURE);
+    }
+
+    fprintf(file, "{\n  \"version\": \"1.3.0\",\n  \"quick\": %s,\n  \"results\": [", isQuick ? "true" : "false");
+
+    for (int i = 0; i < count; ++i)
+    {
+        const Result* result = results + i;
+        double        total  = (double) result->iterations;
+
+        fprintf
+        (
+            file,
+            "%s\n    {\"corpus\": \"%s\", \"workload\": \"%s\", \"bytes\": %zu, \"values\": %ld,"
+            " \"iterations\": %ld, \"seconds\": %.6f, \"mbPerSecond\": %.3f, \"nsPerValue\": %.3f,"
+            " \"allocsPerDoc\": %ld, \"peakRssKb\": %ld}",
+            i == 0 ? "" : ",",
+            result->corpus,
+            result->workload,
+            result->bytes,
+            result->values,
+            result->iterations,
+            result->seconds,
+            (double) result->bytes  * total / result->seconds / 1e6,
+            result->seconds * 1e9 / ((double) result->values * total),
+            result->allocsPerDoc,
+            result->peakRssKb
+        );
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* outputPath = NULL;
+    double      minSeconds = 0.5;
+    long        iterations = 0;
+    bool        isQuick    = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        {
+            isQuick    = true;
+            minSeconds = 0.01;
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            minSeconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+        }
+        else
+        {
+            printf("usage: %s [--quick] [--seconds <min seconds>] [--iterations <count>] [--output <file>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int    corpusCount = (int) (sizeof(corpora) / sizeof(corpora[0]));
+    Result results[sizeof(corpora) / sizeof(corpora[0]) * 3];
+    int    resultCount = 0;
+
+    printf
+    (
+        "%-12s %-10s %10s %10s %10s %12s %12s\n",
+        "corpus", "workload", "KB", "MB/s", "ns/value", "allocs/doc", "peakRssKB"
+    );
+
+    for (int i = 0; i < corpusCount; ++i)
+    {
+        Text text[1] = {{malloc(1024), 0, 1024, 0}};
+
+        randomState = 2463534242u;
+        corpora[i].Generate(text, isQuick ? 1 : 16);
+
+        for (Workload workload = Workload_Parse; workload <= Workload_Access; ++workload)
+        {
+            Result* result = results + resultCount++;
+            *result        = RunWorkload(corpora + i, text, workload, minSeconds, iterations);
+
+            printf
+            (
+                "%-12s %-10s %10zu %10.1f %10.2f %12ld %12ld\n",
+                result->corpus,
+                result->workload,
+                result->bytes / 1024,
+                (double) result->bytes * (double) result->iterations / result->seconds / 1e6,
+                result->seconds * 1e9 / ((double) result->values * (double) result->iterations),
+                result->allocsPerDoc,
+                result->peakRssKb
+            );
+        }
+
+        free(text->data);
+    }
+
+    if (outputPath != NULL)
+    {
+        WriteResults(outputPath, results, resultCount, isQuick);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) scott.cgi All Rights Reserved.
+ *
+ * This source code belongs to project MojoJson, which is hosted on GitHub, and licensed under the MIT License.
+ *
+ * License: https://github.com/scottcgi/MojoJson/blob/master/LICENSE
+ * GitHub : https://github.com/scottcgi/MojoJson
+ *
+ * Since  : 2026-10-18
+ * Author : scott.cgi
+ * Version: 1.3.0
+ */
+
+
+/**
+ * The command line tool of AJsonIndex on POSIX, the json file is mmap.
+ *
+ * build the sidecar index: JsonIndex build <jsonFile> <indexFile> [key]
+ * print record by index  : JsonIndex get   <jsonFile> <indexFile> <record>
+ * print record by value  : JsonIndex find  <jsonFile> <indexFile> <value>
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../Json.h"
+
+
+/**
+ * Map the whole file as read only, if failed return NULL.
+ */
+static const char* MapFile(const char* filePath, size_t* outLength)
+{
+    int fd = open(filePath, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    struct stat fileStat;
+    void*       data = MAP_FAILED;
+
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        data = mmap(NULL, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    // the mapping keeps the file
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    *outLength = (size_t) fileStat.st_size;
+
+    return data;
+}
+
+
+static int PrintRecord(JsonIndex* index, const char* json, size_t jsonLength, int record)
+{
+    size_t offset;
+    size_t length;
+
+    if
+    (
+        AJsonIndex->GetRecord(index, record, &offset, &length) == false ||
+        length > jsonLength                                            ||
+        offset > jsonLength - length
+    )
+    {
+        fprintf(stderr, "JsonIndex record %d not found\n", record);
+        return EXIT_FAILURE;
+    }
+
+    printf("%d\t", record);
+    fwrite(json + offset, 1, length, stdout);
+    printf("\n");
+
+    return EXIT_SUCCESS;
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 4 || (strcmp(argv[1], "build") != 0 && argc < 5))
+    {
+        fprintf
+        (
+            stderr,
+            "Usage: JsonIndex build <jsonFile> <indexFile> [key]\n"
+            "       JsonIndex get   <jsonFile> <indexFile> <record>\n"
+            "       JsonIndex find  <jsonFile> <indexFile> <value>\n"
+        );
+
+        return EXIT_FAILURE;
+    }
+
+    size_t      length;
+    const char* json = MapFile(argv[2], &length);
+
+    if (json == NULL)
+    {
+        fprintf(stderr, "JsonIndex cannot map %s\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    int        result = EXIT_FAILURE;
+    JsonIndex* index;
+
+    if (strcmp(argv[1], "build") == 0)
+    {
+        index = AJsonIndex->Build(json, length, argc > 4 ? argv[4] : NULL);
+
+        if (index == NULL)
+        {
+            fprintf(stderr, "JsonIndex cannot build %s, the record is incomplete\n", argv[2]);
+        }
+        else if (AJsonIndex->Save(index, argv[3]) == false)
+        {
+            fprintf(stderr, "JsonIndex cannot save %s\n", argv[3]);
+        }
+        else
+        {
+            printf("JsonIndex %d records\n", AJsonIndex->GetCount(index));
+            result = EXIT_SUCCESS;
+        }
+    }
+    else if ((index = AJsonIndex->Load(argv[3])) == NULL)
+    {
+        fprintf(stderr, "JsonIndex cannot load %s\n", argv[3]);
+    }
+    else if (AJsonIndex->IsSource(index, json, length) == false)
+    {
+        fprintf(stderr, "JsonIndex %s is not built from %s\n", argv[3], argv[2]);
+    }
+    else if (strcmp(argv[1], "get") == 0)
+    {
+        result = PrintRecord(index, json, length, atoi(argv[4]));
+    }
+    else if (strcmp(argv[1], "find") == 0)
+    {
+        int record = AJsonIndex->FindKey(index, json, length, argv[4], (int) strlen(argv[4]));
+        result     = PrintRecord(index, json, length, record);
+    }
+    else
+    {
+        fprintf(stderr, "JsonIndex unknown command %s\n", argv[1]);
+    }
+
+    if (index != NULL)
+    {
+        AJsonIndex->Destroy(index);
+    }
+
+    munmap((void*) json, length);
+
+    return result;
+}